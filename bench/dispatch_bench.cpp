@@ -0,0 +1,127 @@
+// Measures the per-command cost of parsing and dispatching argv.
+//
+// Usage: bin/dispatch_bench [iterations]
+//
+// "before" reproduces the original CommandHandler::execute: copy every argument
+// into a std::vector<std::string>, route through a chain of string comparisons
+// and parse numbers with std::stoi inside try/catch. "after" uses the dispatch
+// table lookup, CommandArgs views and std::from_chars. Neither side runs the
+// command itself, so only parsing and dispatch are measured.
+
+#include "commands.h"
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+// Command lines as the shell would pass them, including one unknown command
+std::vector<std::vector<std::string>> commandLines = {
+    {"main", "add", "socks", "2", "home"},
+    {"main", "remove", "socks", "1"},
+    {"main", "move", "socks", "all", "home", "suitcase"},
+    {"main", "move", "charger", "3", "home", "suitcase"},
+    {"main", "list", "suitcase"},
+    {"main", "find", "passport"},
+    {"main", "at", "12", "list"},
+    {"main", "diff", "3", "5"},
+    {"main", "help"},
+    {"main", "unpack", "everything"},
+};
+
+// Index of the argument holding a number, shared by both paths so it cancels out
+std::size_t numberArgument(std::string_view command) {
+    if (command == "add" || command == "remove" || command == "move" || command == "diff") return 1;
+    if (command == "at") return 0;
+    return static_cast<std::size_t>(-1);
+}
+
+volatile long sink;
+
+long before(int argc, char* argv[]) {
+    std::string command = argv[1];
+    std::vector<std::string> args;
+    for (int i = 2; i < argc; i++) {
+        args.push_back(argv[i]);
+    }
+
+    long route;
+    if (command == "add") route = 1;
+    else if (command == "remove") route = 2;
+    else if (command == "move") route = 3;
+    else if (command == "list") route = 4;
+    else if (command == "find") route = 5;
+    else if (command == "history") route = 6;
+    else if (command == "at") route = 7;
+    else if (command == "diff") route = 8;
+    else if (command == "reshard") route = 9;
+    else if (command == "help") route = 10;
+    else return 0;
+
+    std::size_t index = numberArgument(command);
+    if (index < args.size() && args[index] != "all") {
+        try {
+            route += std::stoi(args[index]);
+        } catch (...) {
+            route += 100;
+        }
+    }
+    return route + static_cast<long>(args.size());
+}
+
+long after(int argc, char* argv[]) {
+    std::string_view command = argv[1];
+    if (!CommandHandler::hasCommand(command)) {
+        return 0;
+    }
+
+    CommandArgs args(std::span<char* const>(argv + 2, argc - 2));
+    long route = 1;
+    std::size_t index = numberArgument(command);
+    if (index < args.size() && args[index] != "all") {
+        route += CommandHandler::parseNumber(args[index]).value_or(100);
+    }
+    return route + static_cast<long>(args.size());
+}
+
+double nanosecondsPerCommand(long (*run)(int, char*[]), std::vector<std::vector<char*>> &argvs, long iterations) {
+    auto start = std::chrono::steady_clock::now();
+    long total = 0;
+    for (long i = 0; i < iterations; i++) {
+        auto &argv = argvs[i % argvs.size()];
+        total += run(static_cast<int>(argv.size()), argv.data());
+    }
+    sink = total;
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / iterations;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    long iterations = argc > 1 ? std::stol(argv[1]) : 5000000;
+
+    std::vector<std::vector<char*>> argvs;
+    for (auto &line : commandLines) {
+        std::vector<char*> args;
+        for (auto &arg : line) {
+            args.push_back(arg.data());
+        }
+        argvs.push_back(args);
+    }
+
+    // Warm up both paths before timing
+    nanosecondsPerCommand(before, argvs, iterations / 10);
+    nanosecondsPerCommand(after, argvs, iterations / 10);
+
+    double beforeNs = nanosecondsPerCommand(before, argvs, iterations);
+    double afterNs = nanosecondsPerCommand(after, argvs, iterations);
+
+    std::printf("Commands parsed: %ld (%zu distinct command lines)\n\n", iterations, argvs.size());
+    std::printf("%-40s %10.1f ns/command\n", "before (vector<string>, if/else, stoi)", beforeNs);
+    std::printf("%-40s %10.1f ns/command\n", "after (dispatch table, views, from_chars)", afterNs);
+    std::printf("\nSpeedup: %.1fx\n", beforeNs / afterNs);
+    return 0;
+}
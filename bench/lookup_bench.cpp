@@ -0,0 +1,135 @@
+// Compares find latency through the memory-mapped index with loading the
+// whole inventory first.
+//
+// Usage: bin/lookup_bench [item_count] [cold_runs] [warm_lookups]
+//
+// - full load + find: Inventory::loadFromFile on the JSON file, then findItem
+// - cold lookup: map the index and look up one name, after asking the kernel to
+//   drop the index file from the page cache (where posix_fadvise is available)
+// - warm lookup: repeated MappedInventory::find on an already mapped index
+
+#include "inventory.h"
+#include "mapped_inventory.h"
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <nlohmann/json.hpp>
+
+namespace {
+
+const char* const locations[] = {
+    "home", "suitcase", "backpack", "office", "travel-bag", "car",
+    "parents-house", "storage-unit", "gym-locker", "carry-on"
+};
+
+std::string itemName(std::size_t i) {
+    return "item-" + std::to_string(i);
+}
+
+// Writes the data file and its index, returning the items for later lookups
+void makeFiles(std::size_t count, const std::string &dataFile, const std::string &indexFile) {
+    std::mt19937 rng(7);
+    std::vector<Item> items;
+    nlohmann::json j = nlohmann::json::array();
+    for (std::size_t i = 0; i < count; i++) {
+        items.push_back(Item(itemName(i), 1 + rng() % 20, locations[rng() % std::size(locations)]));
+        j.push_back(items.back().toJson());
+    }
+    std::ofstream(dataFile) << j.dump(4);
+    MappedInventory::write(indexFile, items, *MappedInventory::stamp(dataFile));
+}
+
+void dropFromPageCache(const std::string &filename) {
+#ifdef POSIX_FADV_DONTNEED
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        close(fd);
+    }
+#else
+    (void)filename;
+#endif
+}
+
+double microsecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t count = argc > 1 ? std::stoul(argv[1]) : 200000;
+    int coldRuns = argc > 2 ? std::stoi(argv[2]) : 200;
+    long warmLookups = argc > 3 ? std::stol(argv[3]) : 2000000;
+
+    auto dir = std::filesystem::temp_directory_path();
+    std::string dataFile = (dir / "lookup_bench.json").string();
+    std::string indexFile = (dir / "lookup_bench.idx").string();
+    makeFiles(count, dataFile, indexFile);
+
+    std::mt19937 rng(11);
+    std::vector<std::string> queries;
+    for (int i = 0; i < 1024; i++) {
+        // One in eight queries misses, which walks a probe sequence to its end
+        queries.push_back(i % 8 == 0 ? "missing-" + std::to_string(i) : itemName(rng() % count));
+    }
+
+    // Full load, then find
+    int loadRuns = 3;
+    double loadTotal = 0;
+    for (int r = 0; r < loadRuns; r++) {
+        auto start = std::chrono::steady_clock::now();
+        Inventory inventory;
+        inventory.loadFromFile(dataFile);
+        auto item = inventory.findItem(queries[r + 1]);
+        loadTotal += microsecondsSince(start);
+        if (!item) {
+            std::cerr << "Full load lookup failed\n";
+            return 1;
+        }
+    }
+
+    // Cold: fresh mapping each time, index evicted from the page cache first
+    double coldTotal = 0;
+    for (int r = 0; r < coldRuns; r++) {
+        dropFromPageCache(indexFile);
+        auto start = std::chrono::steady_clock::now();
+        MappedInventory mapped;
+        mapped.open(indexFile);
+        auto item = mapped.find(queries[(r % (queries.size() - 1)) + 1]);
+        coldTotal += microsecondsSince(start);
+        if (!mapped.isOpen()) {
+            std::cerr << "Could not map index\n";
+            return 1;
+        }
+        (void)item;
+    }
+
+    // Warm: one mapping, many lookups
+    MappedInventory mapped;
+    mapped.open(indexFile);
+    long found = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < warmLookups; i++) {
+        found += mapped.find(queries[i % queries.size()]).has_value();
+    }
+    double warmTotal = microsecondsSince(start);
+
+    std::printf("Items: %zu, data file %.1f KB, index %.1f KB\n\n", count,
+                std::filesystem::file_size(dataFile) / 1e3, std::filesystem::file_size(indexFile) / 1e3);
+    std::printf("%-24s %14.1f us/lookup\n", "full load + find", loadTotal / loadRuns);
+    std::printf("%-24s %14.1f us/lookup\n", "cold mapped lookup", coldTotal / coldRuns);
+    std::printf("%-24s %14.3f us/lookup\n", "warm mapped lookup", warmTotal / warmLookups);
+    std::printf("\nWarm hits: %ld of %ld\n", found, warmLookups);
+
+    std::filesystem::remove(dataFile);
+    std::filesystem::remove(indexFile);
+    return 0;
+}
@@ -0,0 +1,99 @@
+// Compares JSON and block-compressed inventory storage.
+//
+// Usage: bin/storage_bench [item_count] [runs]
+//
+// Reports file size, compression ratio, and save/load throughput. Throughput is
+// measured in items per second and in megabytes of the JSON-equivalent data
+// per second, so both formats are compared on the same logical amount of data.
+
+#include "inventory.h"
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <nlohmann/json.hpp>
+
+namespace {
+
+const char* const words[] = {
+    "socks", "shirt", "charger", "laptop", "toothbrush", "passport", "adapter",
+    "headphones", "jacket", "umbrella", "notebook", "sunglasses", "towel", "book"
+};
+
+const char* const locations[] = {
+    "home", "suitcase", "backpack", "office", "travel-bag", "car",
+    "parents-house", "storage-unit", "gym-locker", "carry-on"
+};
+
+// Builds the inventory through a JSON file, since addItem's duplicate check is linear
+Inventory makeInventory(std::size_t count, const std::string &filename) {
+    std::mt19937 rng(42);
+    nlohmann::json j = nlohmann::json::array();
+    for (std::size_t i = 0; i < count; i++) {
+        std::string name = std::string(words[rng() % std::size(words)]) + "-" + std::to_string(i);
+        j.push_back(Item(name, 1 + rng() % 20, locations[rng() % std::size(locations)]).toJson());
+    }
+    std::ofstream(filename) << j.dump(4);
+
+    Inventory inventory;
+    inventory.loadFromFile(filename);
+    return inventory;
+}
+
+// Returns the best wall time of several runs in seconds
+double bestOf(int runs, const std::function<void()> &work) {
+    double best = 1e9;
+    for (int r = 0; r < runs; r++) {
+        auto start = std::chrono::steady_clock::now();
+        work();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t count = argc > 1 ? std::stoul(argv[1]) : 200000;
+    int runs = argc > 2 ? std::stoi(argv[2]) : 5;
+
+    auto dir = std::filesystem::temp_directory_path();
+    std::string jsonFile = (dir / "storage_bench.json").string();
+    std::string compressedFile = (dir / "storage_bench.tpk").string();
+    Inventory inventory = makeInventory(count, jsonFile);
+
+    double jsonSave = bestOf(runs, [&] { inventory.saveToFile(jsonFile, StorageFormat::Json); });
+    double compressedSave = bestOf(runs, [&] { inventory.saveToFile(compressedFile, StorageFormat::Compressed); });
+
+    Inventory loaded;
+    double jsonLoad = bestOf(runs, [&] { loaded.loadFromFile(jsonFile); });
+    double compressedLoad = bestOf(runs, [&] { loaded.loadFromFile(compressedFile); });
+    if (loaded.getTotalItems() != inventory.getTotalItems()) {
+        std::cerr << "Round trip lost items\n";
+        return 1;
+    }
+
+    double jsonBytes = static_cast<double>(std::filesystem::file_size(jsonFile));
+    double compressedBytes = static_cast<double>(std::filesystem::file_size(compressedFile));
+    double megabytes = jsonBytes / 1e6;
+
+    std::printf("Items: %zu, best of %d runs\n\n", count, runs);
+    std::printf("%-12s %12s %12s %14s %12s %14s\n", "format", "size (KB)", "save (ms)", "save (MB/s)", "load (ms)", "load (MB/s)");
+    std::printf("%-12s %12.1f %12.2f %14.1f %12.2f %14.1f\n", "json",
+                jsonBytes / 1e3, jsonSave * 1e3, megabytes / jsonSave, jsonLoad * 1e3, megabytes / jsonLoad);
+    std::printf("%-12s %12.1f %12.2f %14.1f %12.2f %14.1f\n", "compressed",
+                compressedBytes / 1e3, compressedSave * 1e3, megabytes / compressedSave,
+                compressedLoad * 1e3, megabytes / compressedLoad);
+    std::printf("\nCompression ratio: %.2fx\n", jsonBytes / compressedBytes);
+    std::printf("Items/s: save %.0f vs %.0f, load %.0f vs %.0f (json vs compressed)\n",
+                count / jsonSave, count / compressedSave, count / jsonLoad, count / compressedLoad);
+
+    std::filesystem::remove(jsonFile);
+    std::filesystem::remove(compressedFile);
+    return 0;
+}
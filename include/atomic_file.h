@@ -0,0 +1,20 @@
+#ifndef ATOMIC_FILE_H
+#define ATOMIC_FILE_H
+
+#include <functional>
+#include <string>
+
+/**
+ * @brief Replaces a file so that readers never see a partially written version
+ *
+ * The new contents are written to a temporary file next to the target, which is
+ * then renamed over it. On failure the target is left as it was and the
+ * temporary file is removed.
+ *
+ * @param filename Path of the file to replace
+ * @param write Writes the new contents to the path it is given, returning false on error
+ * @return true if the file was replaced, false on error
+ */
+bool replaceFile(const std::string &filename, const std::function<bool(const std::string&)> &write);
+
+#endif
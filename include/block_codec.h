@@ -0,0 +1,61 @@
+#ifndef BLOCK_CODEC_H
+#define BLOCK_CODEC_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "item.h"
+
+/**
+ * @class BlockCodec
+ * @brief Compact binary encoding of item lists in independently decodable blocks
+ *
+ * Items are split into blocks of a fixed number of items. Each block carries its
+ * own sorted, front-coded dictionary of the names and locations it uses, and
+ * stores every item as two dictionary indices plus a quantity, all as varints.
+ * Repeated location strings therefore cost one or two bytes per item, and no
+ * block depends on another, so blocks are decoded in parallel.
+ *
+ * Layout:
+ * - magic "TPK1"
+ * - varint block count, then the byte length of each block
+ * - blocks: varint item count, varint dictionary size, front-coded dictionary
+ *   entries (shared prefix length, suffix length, suffix bytes), then per item
+ *   name index, location index and zigzag-encoded quantity
+ */
+class BlockCodec {
+    public:
+        /**
+         * @brief Default number of items per block
+         */
+        static constexpr std::size_t defaultBlockItems = 4096;
+
+        /**
+         * @brief Checks whether data starts with the compressed format's magic bytes
+         * @param data The raw file contents
+         * @return true if the data is in the compressed format
+         */
+        static bool isCompressed(std::string_view data);
+
+        /**
+         * @brief Encodes items into the compressed format
+         * @param items The items to encode, in order
+         * @param blockItems Maximum number of items per block
+         * @return The encoded bytes
+         */
+        static std::string encode(const std::vector<Item> &items, std::size_t blockItems = defaultBlockItems);
+
+        /**
+         * @brief Decodes items from the compressed format
+         *
+         * Blocks are decoded concurrently and concatenated in their original order.
+         *
+         * @param data The encoded bytes
+         * @return The decoded items
+         * @throws std::runtime_error if the data is truncated or malformed
+         */
+        static std::vector<Item> decode(std::string_view data);
+};
+
+#endif
@@ -1,9 +1,65 @@
 #ifndef COMMANDS_H
 #define COMMANDS_H
 
-#include "inventory.h"
+#include "sharded_inventory.h"
+#include "history.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
 #include <string>
-#include <vector>
+#include <string_view>
+
+/**
+ * @class CommandArgs
+ * @brief Non-owning view of a command's arguments
+ *
+ * Wraps the argv entries following the command name and hands them out as
+ * std::string_view, so parsing a command never copies its arguments.
+ */
+class CommandArgs {
+    private:
+        std::span<char* const> values;
+        
+    public:
+        /**
+         * @brief Constructs an empty argument list
+         */
+        CommandArgs() = default;
+        
+        /**
+         * @brief Constructs a view over argv entries
+         * @param values The argument strings
+         */
+        explicit CommandArgs(std::span<char* const> values);
+        
+        /**
+         * @brief Gets the number of arguments
+         * @return The argument count
+         */
+        std::size_t size() const;
+        
+        /**
+         * @brief Checks whether there are no arguments
+         * @return true if the argument list is empty
+         */
+        bool empty() const;
+        
+        /**
+         * @brief Gets an argument by position
+         * @param index The argument index (must be less than size())
+         * @return View of the argument text
+         */
+        std::string_view operator[](std::size_t index) const;
+        
+        /**
+         * @brief Gets the arguments after the first few
+         * @param count The number of leading arguments to skip
+         * @return View of the remaining arguments
+         */
+        CommandArgs dropFront(std::size_t count) const;
+};
 
 /**
  * @class CommandHandler
@@ -19,59 +75,155 @@
  * - move: Move items between locations
  * - list: Display items (all or by location)
  * - find: Search for specific items
+ * - history: List saved versions
+ * - at: Run 'list' or 'find' against a saved version
+ * - diff: Compare two saved versions
+ * - reshard: Change the number of data files the inventory is split across
  * - help: Display usage information
  */
 class CommandHandler {
     private:
-        Inventory& inventory;
+        using Handler = void (CommandHandler::*)(CommandArgs);
+        
+        /**
+         * @brief One command name and the member function that runs it
+         */
+        struct CommandEntry {
+            std::string_view verb;
+            Handler handler;
+        };
+        
+        /**
+         * @brief Perfect hash table from command name to handler
+         * 
+         * Built at compile time: the seed is chosen so that every command name
+         * hashes to its own slot, so a lookup is one hash and one comparison.
+         */
+        struct DispatchTable {
+            static constexpr std::size_t size = 16;
+            std::uint32_t seed;
+            std::array<CommandEntry, size> slots;
+        };
+        
+        static const DispatchTable dispatchTable;
+        
+        ShardedInventory& inventory;
+        History& history;
+        
+        /**
+         * @brief Looks up the dispatch table entry for a command name
+         * @param verb The command name
+         * @return Pointer to the entry, or nullptr if there is no such command
+         */
+        static const CommandEntry* lookupCommand(std::string_view verb);
+        
+        /**
+         * @brief Runs 'list' against an inventory or snapshot
+         * @param view The inventory or snapshot to list
+         * @param args Command arguments: [] for all items, or [location] to filter
+         */
+        void listIn(const InventoryView& view, CommandArgs args);
+        
+        /**
+         * @brief Runs 'find' against an inventory or snapshot
+         * @param view The inventory or snapshot to search
+         * @param args Command arguments: [name]
+         */
+        void findIn(const InventoryView& view, CommandArgs args);
         
         /**
          * @brief Executes the 'add' command
          * @param args Command arguments: [name, quantity, location]
          */
-        void addCommand(const std::vector<std::string>& args);
+        void addCommand(CommandArgs args);
         
         /**
          * @brief Executes the 'remove' command
          * @param args Command arguments: [name] or [name, quantity]
          */
-        void removeCommand(const std::vector<std::string>& args);
+        void removeCommand(CommandArgs args);
         
         /**
          * @brief Executes the 'move' command
          * @param args Command arguments: [name, quantity|"all", from_location, to_location]
          */
-        void moveCommand(const std::vector<std::string>& args);
+        void moveCommand(CommandArgs args);
         
         /**
          * @brief Executes the 'list' command
          * @param args Command arguments: [] for all items, or [location] to filter
          */
-        void listCommand(const std::vector<std::string>& args);
+        void listCommand(CommandArgs args);
         
         /**
          * @brief Executes the 'find' command
          * @param args Command arguments: [name]
          */
-        void findCommand(const std::vector<std::string>& args);
+        void findCommand(CommandArgs args);
+        
+        /**
+         * @brief Executes the 'history' command
+         * @param args Ignored
+         */
+        void historyCommand(CommandArgs args);
+        
+        /**
+         * @brief Executes the 'at' command
+         * @param args Command arguments: [version, "list"|"find", ...]
+         */
+        void atCommand(CommandArgs args);
+        
+        /**
+         * @brief Executes the 'diff' command
+         * @param args Command arguments: [from_version] or [from_version, to_version]
+         */
+        void diffCommand(CommandArgs args);
+        
+        /**
+         * @brief Executes the 'reshard' command
+         * @param args Command arguments: [shard_count]
+         */
+        void reshardCommand(CommandArgs args);
         
         /**
          * @brief Displays help information with command usage examples
+         * @param args Ignored
          */
-        void helpCommand();
+        void helpCommand(CommandArgs args = {});
         
     public:
         /**
-         * @brief Constructs a CommandHandler with an inventory reference
+         * @brief Constructs a CommandHandler with inventory and history references
          * @param inv Reference to the inventory to operate on
+         * @param hist Reference to the version history used by 'history', 'at' and 'diff'
+         */
+        CommandHandler(ShardedInventory& inv, History& hist);
+        
+        /**
+         * @brief Checks whether a command name is known
+         * @param verb The command name
+         * @return true if the command exists
+         */
+        static bool hasCommand(std::string_view verb);
+        
+        /**
+         * @brief Parses a whole argument as a decimal integer
+         * 
+         * Uses std::from_chars, so no exceptions or allocations are involved.
+         * A single leading '+' is accepted; any other leading or trailing
+         * characters, including whitespace, make the argument invalid.
+         * 
+         * @param text The argument text
+         * @return The parsed value, or std::nullopt if the text is not a number
          */
-        CommandHandler(Inventory& inv);
+        static std::optional<int> parseNumber(std::string_view text);
         
         /**
          * @brief Parses and executes a command from command-line arguments
          * 
-         * The first argument (after program name) is the command, and remaining
-         * arguments are passed to the specific command handler.
+         * The first argument (after program name) is the command, which is looked up
+         * in the dispatch table. Remaining arguments are passed to the specific command
+         * handler as views into argv.
          * 
          * @param argc Number of command-line arguments
          * @param argv Array of command-line argument strings
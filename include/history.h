@@ -0,0 +1,276 @@
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <vector>
+#include <string>
+#include "item.h"
+#include "inventory.h"
+#include "mapped_inventory.h"
+#include "snapshot.h"
+
+/**
+ * @struct ItemDiff
+ * @brief The quantity of one (name, location) pair in two different versions
+ */
+struct ItemDiff {
+    std::string name;
+    std::string location;
+    int before;
+    int after;
+};
+
+/**
+ * @struct Version
+ * @brief One committed point in the inventory's history
+ *
+ * The changes hold the net quantity change of each (name, location) pair touched
+ * by the version. The snapshot is only built once the history is fully loaded.
+ */
+struct Version {
+    int id;
+    std::int64_t timestamp;
+    std::vector<ItemDelta> changes;
+    Snapshot snapshot;
+};
+
+/**
+ * @struct RetentionPolicy
+ * @brief Controls how much history is kept
+ *
+ * Versions beyond maxVersions or older than maxAge are folded into the base
+ * snapshot. Folding rewrites the base file, so once more than maxVersions are
+ * kept, foldSlack extra versions are folded at the same time and the next
+ * foldSlack commits only append. Versions older than compactAfter are compacted
+ * so that at most one version per calendar day (UTC) remains.
+ */
+struct RetentionPolicy {
+    std::size_t maxVersions = 200;
+    std::size_t foldSlack = 50;
+    std::chrono::days maxAge{365};
+    std::chrono::days compactAfter{30};
+};
+
+/**
+ * @class History
+ * @brief Versioned history of the inventory built on structurally shared snapshots
+ *
+ * History keeps a base snapshot followed by a list of versions, each holding the
+ * changes it introduced. Once load() is called, every version's Snapshot is
+ * rebuilt by replaying the changes on top of the base; snapshots share all
+ * untouched nodes, so this costs memory proportional to the changes only.
+ *
+ * On disk the history is split in two files:
+ * - <baseName>.history.v<id>.idx: the base items as a MappedInventory index,
+ *   written under a new name only when retention folds versions into the base
+ * - <baseName>.history.log: one JSON line naming the base version, then one line
+ *   per version with its changes; a commit appends a single line
+ *
+ * Both are read lazily. Committing a version reads only the log. diff() and
+ * listVersions() read the log and look up the pairs the versions touch in the
+ * mapped base file, so their cost follows the size of the log rather than the
+ * inventory. The base items are read in full and the snapshots rebuilt only
+ * for at() (load()) or when retention folds versions into the base. Runs that
+ * change nothing read neither file.
+ *
+ * If a history file exists but cannot be read, the error is reported and the
+ * history is left untouched on disk for the rest of the run.
+ */
+class History {
+    private:
+        std::string baseName;
+        int baseId = 0;
+        std::int64_t baseTimestamp = 0;
+        Snapshot base;
+        MappedInventory baseFile;
+        std::vector<Version> versions;
+        bool logLoaded = false;
+        bool snapshotsLoaded = false;
+        bool unreadable = false;
+        std::size_t savedVersions = 0;
+        std::optional<int> savedBaseId;
+        bool logDirty = false;
+        bool baseDirty = false;
+
+        /**
+         * @brief Gets the path of the file holding the items of a base version
+         * @param id The base version id
+         * @return Path of the base file
+         */
+        std::string baseFilename(int id) const;
+
+        /**
+         * @brief Gets the path of the append-only version log
+         * @return Path of the log file
+         */
+        std::string logFilename() const;
+
+        /**
+         * @brief Reads the version log if it is not read yet
+         * @return true if the log is available, false if it could not be read
+         */
+        bool readLog();
+
+        /**
+         * @brief Maps the base file named by the log if it is not mapped yet
+         * @return true if the base file is open, false if it could not be read
+         */
+        bool openBase();
+
+        /**
+         * @brief Gets the quantity of a pair in the base version
+         *
+         * Reads the base snapshot once it is built, the mapped base file otherwise.
+         *
+         * @param name The item name
+         * @param location The item location
+         * @return The quantity, 0 if the pair is not in the base
+         */
+        int baseQuantity(const std::string &name, const std::string &location) const;
+
+        /**
+         * @brief Reads the base items and rebuilds every version's snapshot
+         * @return true if the snapshots are available, false if the base could not be read
+         */
+        bool readSnapshots();
+
+        /**
+         * @brief Finds a retained version by id
+         * @param id The version id
+         * @return Pointer to the version, or nullptr if it is not retained
+         */
+        const Version* findVersion(int id) const;
+
+    public:
+        /**
+         * @brief Opens the history stored next to an inventory
+         *
+         * No file is read yet.
+         *
+         * @param baseName Inventory path without extension (e.g. "inventory")
+         */
+        explicit History(const std::string &baseName);
+
+        /**
+         * @brief Checks whether the version log exists on disk
+         * @return true if a history was saved before, even an unreadable one
+         */
+        bool exists() const;
+
+        /**
+         * @brief Replaces the history with a single base version of the given items
+         *
+         * Used the first time history is enabled for an existing inventory.
+         *
+         * @param items The current inventory contents
+         */
+        void seed(const std::vector<Item> &items);
+
+        /**
+         * @brief Reads the version log without the base items
+         *
+         * Enough for latestId(), hasVersion(), diff() and listVersions().
+         * Errors are reported on stderr.
+         *
+         * @return true if the log is loaded, false if it could not be read
+         */
+        bool loadVersions();
+
+        /**
+         * @brief Reads the whole history and rebuilds every version's snapshot
+         *
+         * Must be called before at(). Errors are reported on stderr.
+         *
+         * @return true if the history is loaded, false if it could not be read
+         */
+        bool load();
+
+        /**
+         * @brief Commits a new version from a change journal
+         *
+         * Deltas are summed per (name, location) pair. Only the log is read, so
+         * the cost does not depend on the size of the inventory. Nothing is
+         * committed if the deltas cancel out or the history cannot be read.
+         *
+         * @param deltas The changes returned by Inventory::takeChanges()
+         * @return true if a new version was created, false otherwise
+         */
+        bool commit(const std::vector<ItemDelta> &deltas);
+
+        /**
+         * @brief Drops and compacts old versions according to a policy
+         *
+         * Does nothing unless the log was read in this run. The base items are
+         * only read if versions have to be folded into the base.
+         *
+         * @param policy The retention and compaction limits
+         * @param now The current time
+         */
+        void applyRetention(const RetentionPolicy &policy,
+                            std::chrono::system_clock::time_point now = std::chrono::system_clock::now());
+
+        /**
+         * @brief Gets the snapshot for a version
+         * @param id The version id (the base id is also accepted)
+         * @return Pointer to the snapshot, or nullptr if the version is not retained
+         */
+        const Snapshot* at(int id) const;
+
+        /**
+         * @brief Gets the id of the latest version
+         * @return The latest version id, or the base id if nothing was committed
+         */
+        int latestId() const;
+
+        /**
+         * @brief Checks whether a version is retained
+         * @param id The version id (the base id is also accepted)
+         * @return true if the version can be queried
+         */
+        bool hasVersion(int id) const;
+
+        /**
+         * @brief Compares two versions
+         *
+         * Only pairs changed by the versions between the two ids are examined:
+         * their quantities are looked up in the base and the deltas of the log
+         * added up to each version, so no snapshot is built.
+         *
+         * @param fromId The first version
+         * @param toId The second version
+         * @return Entries whose quantity differs, ordered by name and location, or
+         *         std::nullopt if a version is not retained or the base cannot be read
+         */
+        std::optional<std::vector<ItemDiff>> diff(int fromId, int toId);
+
+        /**
+         * @brief Displays the retained versions in a formatted list
+         *
+         * Item counts are derived from the base count and the pairs each version
+         * adds or removes.
+         *
+         * @return true if the list was displayed, false if the base cannot be read
+         */
+        bool listVersions();
+
+        /**
+         * @brief Checks whether the history has changes that need saving
+         * @return true if save() would write anything, always false if the history is unreadable
+         */
+        bool isModified() const;
+
+        /**
+         * @brief Writes pending changes to disk
+         *
+         * New versions are appended to the log. The log is rewritten only after
+         * compaction or folding, and the base file only after folding or seeding;
+         * both are written to a temporary file and renamed into place, base first.
+         *
+         * @return true if successful, false on error or if the history is unreadable
+         */
+        bool save();
+};
+
+#endif
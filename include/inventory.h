@@ -5,6 +5,29 @@
 #include <string>
 #include <optional>
 #include "item.h"
+#include "inventory_view.h"
+
+/**
+ * @struct ItemDelta
+ * @brief A signed quantity change applied to one (name, location) pair
+ *
+ * Inventory records one delta per mutation so that History can build the next
+ * version from the change set alone, without rescanning every item.
+ */
+struct ItemDelta {
+    std::string name;
+    std::string location;
+    int delta;
+};
+
+/**
+ * @enum StorageFormat
+ * @brief On-disk format used when saving an inventory
+ */
+enum class StorageFormat {
+    Json,        ///< Pretty-printed JSON array
+    Compressed   ///< Block-compressed binary, see BlockCodec
+};
 
 /**
  * @class Inventory
@@ -14,9 +37,18 @@
  * CRUD operations, location-based queries, and persistent storage. It automatically
  * merges items when adding duplicates at the same location.
  */
-class Inventory {
+class Inventory : public InventoryView {
     private:
         std::vector<Item> items;
+        std::vector<ItemDelta> changes;
+        
+        /**
+         * @brief Appends a quantity change to the change journal
+         * @param name The name of the changed item
+         * @param location The location whose quantity changed
+         * @param delta The signed change in quantity (ignored if zero)
+         */
+        void recordChange(const std::string &name, const std::string &location, int delta);
         
     public:
         /**
@@ -57,7 +89,7 @@ class Inventory {
          * @param name The name of the item to find
          * @return std::optional containing the item if found, std::nullopt otherwise
          */
-        std::optional<Item> findItem(const std::string &name) const;
+        std::optional<Item> findItem(const std::string &name) const override;
         
         /**
          * @brief Finds an item by name and returns a mutable pointer
@@ -102,47 +134,59 @@ class Inventory {
          * @param location The location to query
          * @return Vector of items at the specified location
          */
-        std::vector<Item> getItemsByLocation(const std::string &location) const;
+        std::vector<Item> getItemsByLocation(const std::string &location) const override;
         
         /**
          * @brief Gets all items in the inventory
-         * @return Const reference to the items vector
+         * @return Copy of the items vector
          */
-        const std::vector<Item>& getAllItems() const;
+        std::vector<Item> getAllItems() const override;
         
         /**
          * @brief Gets the total number of unique items
          * @return The count of items in the inventory
          */
-        int getTotalItems() const;
+        int getTotalItems() const override;
         
-        /**
-         * @brief Displays all items in a formatted list
-         */
-        void listItems() const;
         
-        /**
-         * @brief Displays items at a specific location
-         * @param location The location to filter by
-         */
-        void listItemsByLocation(const std::string &location) const;
         
         /**
-         * @brief Saves the inventory to a JSON file
+         * @brief Saves the inventory to a file
          * @param filename Path to the output file
+         * @param format The on-disk format to write (default: JSON)
          * @return true if successful, false on error
          */
-        bool saveToFile(const std::string& filename) const;
+        bool saveToFile(const std::string& filename, StorageFormat format = StorageFormat::Json) const;
         
         /**
-         * @brief Loads the inventory from a JSON file
+         * @brief Loads the inventory from a file
          * 
-         * Replaces all current items with those from the file.
+         * Replaces all current items with those from the file. The format is
+         * detected from the file contents, so JSON and compressed files both load.
          * 
          * @param filename Path to the input file
          * @return true if successful, false if file doesn't exist or on error
          */
         bool loadFromFile(const std::string& filename);
+        
+        /**
+         * @brief Replaces all items without recording any changes
+         * 
+         * Like loadFromFile, but for items that are already in memory.
+         * 
+         * @param newItems The items to hold
+         */
+        void loadItems(std::vector<Item> newItems);
+        
+        /**
+         * @brief Returns and clears the changes made since the last call
+         * 
+         * Loading from file does not count as a change; every other mutation
+         * contributes one delta per (name, location) pair it touches.
+         * 
+         * @return The journal of quantity deltas, in the order they were applied
+         */
+        std::vector<ItemDelta> takeChanges();
 };
 
 #endif
\ No newline at end of file
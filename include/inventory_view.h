@@ -0,0 +1,59 @@
+#ifndef INVENTORY_VIEW_H
+#define INVENTORY_VIEW_H
+
+#include <vector>
+#include <string>
+#include <optional>
+#include "item.h"
+
+/**
+ * @class InventoryView
+ * @brief Read-only query interface shared by every source of inventory data
+ *
+ * Implemented by the live Inventory as well as by historical snapshots, so that
+ * the 'list' and 'find' commands can run against either without copying items.
+ * The list printers are shared and built on getAllItems()/getItemsByLocation().
+ */
+class InventoryView {
+    public:
+        virtual ~InventoryView() = default;
+
+        /**
+         * @brief Finds an item by name (read-only)
+         * @param name The name of the item to find
+         * @return std::optional containing the item if found, std::nullopt otherwise
+         */
+        virtual std::optional<Item> findItem(const std::string &name) const = 0;
+
+        /**
+         * @brief Gets all items
+         * @return Vector of every item
+         */
+        virtual std::vector<Item> getAllItems() const = 0;
+
+        /**
+         * @brief Gets all items at a specific location
+         * @param location The location to query
+         * @return Vector of items at the specified location
+         */
+        virtual std::vector<Item> getItemsByLocation(const std::string &location) const = 0;
+
+        /**
+         * @brief Gets the total number of unique items
+         * @return The count of items
+         */
+        virtual int getTotalItems() const = 0;
+
+        /**
+         * @brief Displays all items in a formatted list
+         */
+        void listItems() const;
+
+        /**
+         * @brief Displays items at a specific location
+         * @param location The location to filter by
+         */
+        void listItemsByLocation(const std::string &location) const;
+};
+
+#endif
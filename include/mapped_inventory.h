@@ -0,0 +1,195 @@
+#ifndef MAPPED_INVENTORY_H
+#define MAPPED_INVENTORY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <optional>
+#include "item.h"
+#include "inventory_view.h"
+
+/**
+ * @struct MappedItem
+ * @brief An item read in place from a memory-mapped index
+ *
+ * The strings point into the mapping and stay valid while the MappedInventory
+ * that returned them is open.
+ */
+struct MappedItem {
+    std::string_view name;
+    int quantity;
+    std::string_view location;
+};
+
+/**
+ * @struct SourceStamp
+ * @brief Identifies the exact state of the data file an index was built from
+ *
+ * Besides the size and modification time, the status change time is recorded:
+ * it is updated by every write and by every attempt to set the modification
+ * time, so a restored or hand-edited file never matches an old stamp.
+ */
+struct SourceStamp {
+    std::uint64_t size;
+    std::int64_t modified;  ///< Modification time in nanoseconds
+    std::int64_t changed;   ///< Status change time in nanoseconds
+
+    bool operator==(const SourceStamp&) const = default;
+};
+
+/**
+ * @class MappedInventory
+ * @brief Read-only inventory served directly from a memory-mapped index file
+ *
+ * The index file holds every item as a fixed-size record, a blob of the name and
+ * location strings, and an open-addressing hash table (linear probing, load
+ * factor at most 1/2). Slots are hashed on the item name and each record is
+ * matched on name and location, so a lookup touches the header, one or two
+ * cache lines of slots, the record and its strings: a handful of pages, with
+ * no parsing and no allocation.
+ *
+ * Records for the same name are inserted in inventory order, so find() returns
+ * the same entry as Inventory::findItem().
+ *
+ * Layout (native byte order, checked on open):
+ * - header: magic "TPKX", version, byte order marker, slot count, item count,
+ *   SourceStamp of the data file the index was built from, section offsets
+ * - slots: 32-bit name hash and 32-bit record number plus one (0 = empty)
+ * - records: name and location offset/length into the string blob, quantity
+ * - string blob
+ */
+class MappedInventory : public InventoryView {
+    private:
+        struct Header;
+        struct Slot;
+        struct Record;
+
+        const char* data = nullptr;
+        std::size_t size = 0;
+
+        const Header* header() const;
+        const Slot* slots() const;
+        const Record* records() const;
+
+        /**
+         * @brief Resolves a record to a view of its item
+         * @param index The record number
+         * @return The item, or std::nullopt if the record points outside the file
+         */
+        std::optional<MappedItem> itemAt(std::uint64_t index) const;
+
+        /**
+         * @brief Probes the hash table for a name and, optionally, a location
+         * @param name The item name
+         * @param location The location to match, or nullptr to match any location
+         * @return The first matching item, or std::nullopt if there is none
+         */
+        std::optional<MappedItem> probe(std::string_view name, const std::string_view *location) const;
+
+        /**
+         * @brief Unmaps the file, if any
+         */
+        void close();
+
+    public:
+        /**
+         * @brief Constructs a view with no file open
+         */
+        MappedInventory() = default;
+
+        /**
+         * @brief Unmaps the index file
+         */
+        ~MappedInventory() override;
+
+        MappedInventory(const MappedInventory&) = delete;
+        MappedInventory& operator=(const MappedInventory&) = delete;
+        MappedInventory(MappedInventory&& other) noexcept;
+        MappedInventory& operator=(MappedInventory&& other) noexcept;
+
+        /**
+         * @brief Writes an index file for a list of items
+         * @param filename Path to the output file
+         * @param items The items to index, in inventory order
+         * @param source Stamp of the data file the items were saved to, used to detect stale
+         *               indexes; left zero for an index that is the data itself
+         * @return true if successful, false on error
+         */
+        static bool write(const std::string &filename, const std::vector<Item> &items, const SourceStamp &source = {});
+
+        /**
+         * @brief Reads the stamp of a data file
+         * @param filename Path to the data file
+         * @return The file's stamp, or std::nullopt if it cannot be read
+         */
+        static std::optional<SourceStamp> stamp(const std::string &filename);
+
+        /**
+         * @brief Maps an index file read-only
+         *
+         * Only the header is validated; item data is not read until queried.
+         *
+         * @param filename Path to the index file
+         * @return true if the file was mapped and has a valid header, false otherwise
+         */
+        bool open(const std::string &filename);
+
+        /**
+         * @brief Checks whether an index file is mapped
+         * @return true if open() succeeded
+         */
+        bool isOpen() const;
+
+        /**
+         * @brief Gets the stamp of the data file the index was built from
+         * @return The recorded stamp, or std::nullopt if no index is open
+         */
+        std::optional<SourceStamp> getSource() const;
+
+        /**
+         * @brief Finds an item by name without allocating
+         * @param name The name of the item to find
+         * @return View of the item if found, std::nullopt otherwise
+         */
+        std::optional<MappedItem> find(std::string_view name) const;
+
+        /**
+         * @brief Finds an item by name and location without allocating
+         * @param name The name of the item
+         * @param location The location of the item
+         * @return View of the item if found, std::nullopt otherwise
+         */
+        std::optional<MappedItem> find(std::string_view name, std::string_view location) const;
+
+        /**
+         * @brief Finds an item by name, see Inventory::findItem
+         * @param name The name of the item to find
+         * @return std::optional containing the item if found, std::nullopt otherwise
+         */
+        std::optional<Item> findItem(const std::string &name) const override;
+
+        /**
+         * @brief Gets all items by reading every record
+         * @return Vector of all items, in index order
+         */
+        std::vector<Item> getAllItems() const override;
+
+        /**
+         * @brief Gets all items at a specific location by scanning every record
+         * @param location The location to query
+         * @return Vector of items at the specified location
+         */
+        std::vector<Item> getItemsByLocation(const std::string &location) const override;
+
+        /**
+         * @brief Gets the total number of items in the index
+         * @return The count of items
+         */
+        int getTotalItems() const override;
+
+
+};
+
+#endif
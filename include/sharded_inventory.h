@@ -0,0 +1,245 @@
+#ifndef SHARDED_INVENTORY_H
+#define SHARDED_INVENTORY_H
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+#include <string>
+#include <optional>
+#include "item.h"
+#include "inventory.h"
+#include "inventory_view.h"
+#include "mapped_inventory.h"
+
+/**
+ * @class ShardedInventory
+ * @brief An inventory partitioned across several independently stored shards
+ *
+ * Items are assigned to a shard by a stable hash of their name, so every entry
+ * for a name, whatever its location, lives in the same shard. Shards are loaded
+ * lazily: commands that name an item (add, remove, move, find) read only that
+ * item's shard, while whole-inventory queries load and scan all shards in
+ * parallel. Only shards that were modified are written back.
+ *
+ * With indexing enabled, every saved shard also gets a MappedInventory index.
+ * findItem() on a shard that is not loaded yet answers from the memory-mapped
+ * index when it is up to date, without reading the shard's data file at all.
+ * The index is several times larger than a compressed data file and is
+ * rewritten with every save, so it is opt-in.
+ *
+ * The shard count is stored in a small manifest next to the data files. With a
+ * single shard the data file is the plain inventory file, so existing data is
+ * read as-is. Files are written to a temporary name and renamed into place, and
+ * a reshard only takes effect once the new manifest is written, so an interrupted
+ * save never leaves a mix of old and new data. If the manifest exists but cannot
+ * be read, the layout is unknown: nothing is saved, reshard() refuses to run and
+ * changes are dropped from the journal.
+ */
+class ShardedInventory : public InventoryView {
+    private:
+        struct Shard {
+            Inventory inventory;
+            bool loaded = false;
+            bool dirty = false;
+            bool migrating = false;
+            bool indexStale = false;
+            bool unreadable = false;
+        };
+
+        std::string baseName;
+        StorageFormat format;
+        bool useIndex;
+        std::size_t shardCount = 1;
+        mutable std::vector<Shard> shards;
+        std::vector<ItemDelta> pendingChanges;
+        std::vector<std::string> staleFiles;
+        std::vector<std::string> clearedFiles;
+        bool manifestDirty = false;
+        bool manifestUnreadable = false;
+
+        /**
+         * @brief Gets the data file of a shard for a given layout and format
+         * @param index The shard index
+         * @param count The total number of shards
+         * @param fileFormat The storage format, which determines the extension
+         * @return Path of the shard's data file
+         */
+        std::string shardFilename(std::size_t index, std::size_t count, StorageFormat fileFormat) const;
+
+        /**
+         * @brief Gets the index file of a shard for a given layout
+         * @param index The shard index
+         * @param count The total number of shards
+         * @return Path of the shard's MappedInventory index
+         */
+        std::string indexFilename(std::size_t index, std::size_t count) const;
+
+        /**
+         * @brief Maps a shard's index if it matches the shard's current data file
+         * @param index The shard index
+         * @param mapped The view to open the index in
+         * @return true if the index is open and up to date, false otherwise
+         */
+        bool openIndex(std::size_t index, MappedInventory &mapped) const;
+
+        /**
+         * @brief Gets the path of the manifest recording the shard count
+         * @return Path of the manifest file
+         */
+        std::string manifestFilename() const;
+
+        /**
+         * @brief Picks the shard that owns an item name
+         * @param name The item name
+         * @param count The total number of shards
+         * @return Index of the owning shard
+         */
+        std::size_t shardFor(const std::string &name, std::size_t count) const;
+
+        /**
+         * @brief Loads a shard from disk if it is not loaded yet
+         *
+         * Falls back to the file in the other storage format, which is then
+         * converted on the next save. A data file that exists but cannot be read
+         * marks the shard unreadable: its (empty) contents are never saved and
+         * reshard() refuses to run.
+         *
+         * @param index The shard index
+         * @return Reference to the shard
+         */
+        Shard& loadShard(std::size_t index) const;
+
+        /**
+         * @brief Runs a function for every shard index, in parallel
+         *
+         * Shards are split into contiguous runs over at most one task per
+         * hardware thread, so large shard counts do not start a thread each.
+         *
+         * @param work The function to run, called once per shard index
+         */
+        void forEachShard(const std::function<void(std::size_t)> &work) const;
+
+        /**
+         * @brief Loads every shard that is not loaded yet, in parallel
+         */
+        void loadAllShards() const;
+
+    public:
+        /**
+         * @brief Largest supported shard count
+         */
+        static constexpr std::size_t maxShards = 1024;
+        
+        /**
+         * @brief Opens a sharded inventory
+         *
+         * Reads the manifest to find the shard count; no shard data is read yet.
+         *
+         * @param baseName Data file path without extension (e.g. "inventory")
+         * @param format The format used when saving shards
+         * @param useIndex Whether to write MappedInventory indexes and answer findItem() from them
+         */
+        ShardedInventory(const std::string &baseName, StorageFormat format = StorageFormat::Json, bool useIndex = false);
+
+        /**
+         * @brief Gets the number of shards
+         * @return The shard count
+         */
+        std::size_t getShardCount() const;
+
+        /**
+         * @brief Redistributes all items across a new number of shards
+         *
+         * Takes effect on disk at the next save(). Nothing changes if the manifest
+         * or any shard could not be read, so unreadable data is never dropped.
+         *
+         * @param count The new shard count (1 to maxShards)
+         * @return true if successful, false if count is invalid, data is unreadable or memory ran out
+         */
+        bool reshard(std::size_t count);
+
+        /**
+         * @brief Adds an item to its shard, see Inventory::addItem
+         * @param item The item to add
+         */
+        void addItem(const Item &item);
+
+        /**
+         * @brief Removes an item completely, see Inventory::removeItem
+         * @param name The name of the item to remove
+         * @return true if the item was found and removed, false otherwise
+         */
+        bool removeItem(const std::string &name);
+
+        /**
+         * @brief Removes a specific quantity of an item, see Inventory::removeItemQuantity
+         * @param name The name of the item
+         * @param amount The quantity to remove
+         * @return true if the item was found and updated, false otherwise
+         */
+        bool removeItemQuantity(const std::string &name, int amount);
+
+        /**
+         * @brief Moves an item between locations, see Inventory::moveItem
+         *
+         * Both locations of an item live in the same shard, so a move only ever
+         * reads and writes one shard.
+         *
+         * @param name The name of the item to move
+         * @param fromLoc The source location
+         * @param toLoc The destination location
+         * @param quantity The quantity to move (-1 for all items, default: -1)
+         * @return true if successful, false if item not found at source location
+         */
+        bool moveItem(const std::string &name, const std::string &fromLoc,
+                     const std::string &toLoc, int quantity = -1);
+
+        /**
+         * @brief Gets all items from every shard
+         * @return Vector of all items, in shard order
+         */
+        std::vector<Item> getAllItems() const override;
+
+        /**
+         * @brief Finds an item by name, reading only its shard's index or data
+         * @param name The name of the item to find
+         * @return std::optional containing the item if found, std::nullopt otherwise
+         */
+        std::optional<Item> findItem(const std::string &name) const override;
+
+        /**
+         * @brief Gets all items at a specific location, querying shards in parallel
+         * @param location The location to query
+         * @return Vector of items at the specified location, in shard order
+         */
+        std::vector<Item> getItemsByLocation(const std::string &location) const override;
+
+        /**
+         * @brief Gets the total number of unique items across all shards
+         * @return The count of items in the inventory
+         */
+        int getTotalItems() const override;
+
+
+
+        /**
+         * @brief Returns and clears the changes made since the last call
+         *
+         * Changes to unreadable shards, or to any shard if the manifest is
+         * unreadable, are discarded, since they are never saved.
+         *
+         * @return The quantity deltas from every loaded shard
+         */
+        std::vector<ItemDelta> takeChanges();
+
+        /**
+         * @brief Writes modified shards and the manifest back to disk
+         *
+         * Unreadable shards are left untouched on disk.
+         *
+         * @return true if every write succeeded, false otherwise
+         */
+        bool save();
+};
+
+#endif
@@ -0,0 +1,108 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <memory>
+#include <vector>
+#include <string>
+#include <optional>
+#include "item.h"
+#include "inventory_view.h"
+
+/**
+ * @class Snapshot
+ * @brief Immutable, structurally shared view of the inventory at one point in time
+ *
+ * A Snapshot stores one quantity per (name, location) pair in two persistent treaps,
+ * one ordered by name and one ordered by location. Updates never modify existing
+ * nodes: withQuantity() copies only the O(log n) nodes on the path to the changed
+ * key and shares everything else with the original, so keeping many versions
+ * costs memory proportional to the changes between them, not to their size.
+ *
+ * Node priorities are derived from a hash of the key, which makes the shape of each
+ * tree depend only on its contents.
+ */
+class Snapshot : public InventoryView {
+    private:
+        struct Node;
+        using NodePtr = std::shared_ptr<const Node>;
+
+        NodePtr byName;
+        NodePtr byLocation;
+        int count = 0;
+
+        static NodePtr insert(const NodePtr &root, const NodePtr &node);
+        static NodePtr erase(const NodePtr &root, const std::string &primary, const std::string &secondary);
+        static NodePtr merge(const NodePtr &left, const NodePtr &right);
+        static const Node* lookup(const NodePtr &root, const std::string &primary, const std::string &secondary);
+        static void collect(const NodePtr &root, const std::string *primary, bool nameFirst, std::vector<Item> &out);
+
+    public:
+        /**
+         * @brief Constructs an empty snapshot
+         */
+        Snapshot() = default;
+
+        /**
+         * @brief Builds a snapshot from a list of items
+         *
+         * Quantities of items sharing a name and location are summed.
+         *
+         * @param items The items to include
+         * @return Snapshot containing the items
+         */
+        static Snapshot fromItems(const std::vector<Item> &items);
+
+        /**
+         * @brief Returns a new snapshot with one quantity replaced
+         *
+         * This snapshot is left unchanged. A quantity of zero removes the entry.
+         *
+         * @param name The name of the item
+         * @param location The location of the item
+         * @param quantity The new quantity at that location
+         * @return Snapshot sharing all untouched nodes with this one
+         */
+        Snapshot withQuantity(const std::string &name, const std::string &location, int quantity) const;
+
+        /**
+         * @brief Gets the quantity stored for a name at a location
+         * @param name The name of the item
+         * @param location The location of the item
+         * @return The quantity, or 0 if there is no such entry
+         */
+        int getQuantity(const std::string &name, const std::string &location) const;
+
+        /**
+         * @brief Gets all items, ordered by name and then location
+         * @return Vector of every item in the snapshot
+         */
+        std::vector<Item> getAllItems() const override;
+
+        /**
+         * @brief Finds an item by name
+         *
+         * When the name exists at several locations, the alphabetically first
+         * location is returned.
+         *
+         * @param name The name of the item to find
+         * @return std::optional containing the item if found, std::nullopt otherwise
+         */
+        std::optional<Item> findItem(const std::string &name) const override;
+
+        /**
+         * @brief Gets all items at a specific location, ordered by name
+         * @param location The location to query
+         * @return Vector of items at the specified location
+         */
+        std::vector<Item> getItemsByLocation(const std::string &location) const override;
+
+        /**
+         * @brief Gets the number of (name, location) entries
+         * @return The count of items in the snapshot
+         */
+        int getTotalItems() const override;
+
+
+};
+
+#endif
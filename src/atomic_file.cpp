@@ -0,0 +1,20 @@
+#include "atomic_file.h"
+#include <filesystem>
+#include <iostream>
+
+bool replaceFile(const std::string &filename, const std::function<bool(const std::string&)> &write) {
+    std::string temporary = filename + ".tmp";
+    std::error_code error;
+    if (!write(temporary)) {
+        std::filesystem::remove(temporary, error);
+        return false;
+    }
+
+    std::filesystem::rename(temporary, filename, error);
+    if (error) {
+        std::cerr << "Error: Could not replace " << filename << ": " << error.message() << "\n";
+        std::filesystem::remove(temporary, error);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,220 @@
+#include "block_codec.h"
+#include <algorithm>
+#include <cstdint>
+#include <future>
+#include <iterator>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+constexpr std::string_view magic = "TPK1";
+
+void writeVarint(std::string &out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+// Reads values from a byte range, throwing instead of reading past the end
+class Reader {
+    private:
+        std::string_view data;
+        std::size_t pos = 0;
+
+    public:
+        explicit Reader(std::string_view data) : data(data) {}
+
+        std::uint64_t varint() {
+            std::uint64_t value = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                if (pos >= data.size()) {
+                    throw std::runtime_error("Truncated compressed data");
+                }
+                auto byte = static_cast<unsigned char>(data[pos++]);
+                value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+                if (!(byte & 0x80)) {
+                    return value;
+                }
+            }
+            throw std::runtime_error("Invalid varint in compressed data");
+        }
+
+        std::string_view bytes(std::size_t count) {
+            if (count > data.size() - pos) {
+                throw std::runtime_error("Truncated compressed data");
+            }
+            auto result = data.substr(pos, count);
+            pos += count;
+            return result;
+        }
+
+        std::size_t offset() const {
+            return pos;
+        }
+};
+
+std::uint64_t zigzag(int value) {
+    return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(static_cast<std::int64_t>(value) >> 63);
+}
+
+int unzigzag(std::uint64_t value) {
+    return static_cast<int>(static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1));
+}
+
+void encodeBlock(std::string &out, const Item *begin, const Item *end) {
+    // Collect the distinct strings used by this block; sorting lets neighbours share prefixes
+    std::vector<std::string> dictionary;
+    for (const Item *item = begin; item != end; ++item) {
+        dictionary.push_back(item->getName());
+        dictionary.push_back(item->getLocation());
+    }
+    std::sort(dictionary.begin(), dictionary.end());
+    dictionary.erase(std::unique(dictionary.begin(), dictionary.end()), dictionary.end());
+
+    auto indexOf = [&dictionary](const std::string &value) {
+        return static_cast<std::uint64_t>(
+            std::lower_bound(dictionary.begin(), dictionary.end(), value) - dictionary.begin());
+    };
+
+    writeVarint(out, end - begin);
+    writeVarint(out, dictionary.size());
+    std::string_view previous;
+    for (const auto &entry : dictionary) {
+        std::size_t shared = 0;
+        while (shared < previous.size() && shared < entry.size() && previous[shared] == entry[shared]) {
+            shared++;
+        }
+        writeVarint(out, shared);
+        writeVarint(out, entry.size() - shared);
+        out.append(entry, shared);
+        previous = entry;
+    }
+
+    for (const Item *item = begin; item != end; ++item) {
+        writeVarint(out, indexOf(item->getName()));
+        writeVarint(out, indexOf(item->getLocation()));
+        writeVarint(out, zigzag(item->getQuantity()));
+    }
+}
+
+std::vector<Item> decodeBlock(std::string_view block) {
+    Reader reader(block);
+    std::uint64_t itemCount = reader.varint();
+    std::uint64_t dictionarySize = reader.varint();
+    // Every dictionary entry and item takes at least one byte, so larger counts are corrupt
+    if (itemCount > block.size() || dictionarySize > block.size()) {
+        throw std::runtime_error("Corrupt compressed block");
+    }
+
+    std::vector<std::string> dictionary;
+    dictionary.reserve(dictionarySize);
+    for (std::uint64_t i = 0; i < dictionarySize; i++) {
+        std::uint64_t shared = reader.varint();
+        std::uint64_t suffix = reader.varint();
+        if (i == 0 ? shared != 0 : shared > dictionary.back().size()) {
+            throw std::runtime_error("Corrupt compressed block");
+        }
+
+        std::string entry;
+        if (shared > 0) {
+            entry.assign(dictionary.back(), 0, shared);
+        }
+        entry.append(reader.bytes(suffix));
+        dictionary.push_back(std::move(entry));
+    }
+
+    std::vector<Item> items;
+    items.reserve(itemCount);
+    for (std::uint64_t i = 0; i < itemCount; i++) {
+        std::uint64_t name = reader.varint();
+        std::uint64_t location = reader.varint();
+        int quantity = unzigzag(reader.varint());
+        if (name >= dictionary.size() || location >= dictionary.size()) {
+            throw std::runtime_error("Corrupt compressed block");
+        }
+        items.push_back(Item(dictionary[name], quantity, dictionary[location]));
+    }
+    return items;
+}
+
+}
+
+bool BlockCodec::isCompressed(std::string_view data) {
+    return data.starts_with(magic);
+}
+
+std::string BlockCodec::encode(const std::vector<Item> &items, std::size_t blockItems) {
+    blockItems = std::max<std::size_t>(blockItems, 1);
+
+    std::vector<std::string> blocks;
+    for (std::size_t start = 0; start < items.size(); start += blockItems) {
+        std::size_t end = std::min(start + blockItems, items.size());
+        blocks.emplace_back();
+        encodeBlock(blocks.back(), items.data() + start, items.data() + end);
+    }
+
+    // Block lengths up front let the decoder find every block without parsing the others
+    std::string out(magic);
+    writeVarint(out, blocks.size());
+    for (const auto &block : blocks) {
+        writeVarint(out, block.size());
+    }
+    for (const auto &block : blocks) {
+        out += block;
+    }
+    return out;
+}
+
+std::vector<Item> BlockCodec::decode(std::string_view data) {
+    if (!isCompressed(data)) {
+        throw std::runtime_error("Not a compressed inventory");
+    }
+
+    Reader header(data.substr(magic.size()));
+    std::uint64_t blockCount = header.varint();
+    if (blockCount > data.size()) {
+        throw std::runtime_error("Corrupt compressed header");
+    }
+
+    std::vector<std::uint64_t> lengths(blockCount);
+    for (auto &length : lengths) {
+        length = header.varint();
+    }
+
+    std::vector<std::string_view> blocks;
+    Reader body(data.substr(magic.size() + header.offset()));
+    for (auto length : lengths) {
+        blocks.push_back(body.bytes(length));
+    }
+
+    // Hand out contiguous runs of blocks to one task per hardware thread
+    std::size_t taskCount = std::min<std::size_t>(blocks.size(), std::max(1u, std::thread::hardware_concurrency()));
+    std::vector<std::vector<Item>> decoded(blocks.size());
+    std::vector<std::future<void>> tasks;
+    for (std::size_t t = 0; t < taskCount; t++) {
+        std::size_t first = blocks.size() * t / taskCount;
+        std::size_t last = blocks.size() * (t + 1) / taskCount;
+        tasks.push_back(std::async(std::launch::async, [&blocks, &decoded, first, last] {
+            for (std::size_t b = first; b < last; b++) {
+                decoded[b] = decodeBlock(blocks[b]);
+            }
+        }));
+    }
+    for (auto &task : tasks) {
+        task.get();
+    }
+
+    std::vector<Item> items;
+    std::size_t total = 0;
+    for (const auto &block : decoded) {
+        total += block.size();
+    }
+    items.reserve(total);
+    for (auto &block : decoded) {
+        std::move(block.begin(), block.end(), std::back_inserter(items));
+    }
+    return items;
+}
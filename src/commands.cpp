@@ -1,11 +1,108 @@
 #include "commands.h"
+#include <charconv>
 #include <iostream>
 #include <string>
-#include <vector>
+#include <string_view>
 
-CommandHandler::CommandHandler(Inventory& inv) : inventory(inv) {}
+namespace {
 
-void CommandHandler::helpCommand() {
+// FNV-1a with a configurable starting value, usable at compile time
+constexpr std::uint32_t verbHash(std::string_view verb, std::uint32_t seed) {
+    std::uint32_t hash = seed;
+    for (char c : verb) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// The low bits of an FNV hash only depend on the low bits of its input, so use the high half
+constexpr std::size_t verbSlot(std::string_view verb, std::uint32_t seed, std::size_t size) {
+    return (verbHash(verb, seed) >> 16) % size;
+}
+
+}
+
+CommandArgs::CommandArgs(std::span<char* const> values) : values(values) {}
+
+std::size_t CommandArgs::size() const {
+    return values.size();
+}
+
+bool CommandArgs::empty() const {
+    return values.empty();
+}
+
+std::string_view CommandArgs::operator[](std::size_t index) const {
+    return values[index];
+}
+
+CommandArgs CommandArgs::dropFront(std::size_t count) const {
+    return CommandArgs(values.subspan(std::min(count, values.size())));
+}
+
+// Searches for a seed that sends every command to its own slot; fails to compile if none exists
+constexpr CommandHandler::DispatchTable CommandHandler::dispatchTable = [] {
+    constexpr CommandEntry commands[] = {
+        {"add", &CommandHandler::addCommand},
+        {"remove", &CommandHandler::removeCommand},
+        {"move", &CommandHandler::moveCommand},
+        {"list", &CommandHandler::listCommand},
+        {"find", &CommandHandler::findCommand},
+        {"history", &CommandHandler::historyCommand},
+        {"at", &CommandHandler::atCommand},
+        {"diff", &CommandHandler::diffCommand},
+        {"reshard", &CommandHandler::reshardCommand},
+        {"help", &CommandHandler::helpCommand},
+    };
+    static_assert(std::size(commands) <= DispatchTable::size);
+    
+    for (std::uint32_t seed = 2166136261u; ; seed++) {
+        DispatchTable table{seed, {}};
+        bool collision = false;
+        for (const auto &command : commands) {
+            auto &slot = table.slots[verbSlot(command.verb, seed, DispatchTable::size)];
+            if (!slot.verb.empty()) {
+                collision = true;
+                break;
+            }
+            slot = command;
+        }
+        if (!collision) {
+            return table;
+        }
+    }
+}();
+
+CommandHandler::CommandHandler(ShardedInventory& inv, History& hist) : inventory(inv), history(hist) {}
+
+const CommandHandler::CommandEntry* CommandHandler::lookupCommand(std::string_view verb) {
+    const auto &entry = dispatchTable.slots[verbSlot(verb, dispatchTable.seed, DispatchTable::size)];
+    if (!entry.verb.empty() && entry.verb == verb) {
+        return &entry;
+    }
+    return nullptr;
+}
+
+bool CommandHandler::hasCommand(std::string_view verb) {
+    return lookupCommand(verb) != nullptr;
+}
+
+std::optional<int> CommandHandler::parseNumber(std::string_view text) {
+    // std::from_chars rejects a leading '+', which std::stoi used to accept
+    if (text.size() > 1 && text[0] == '+' && text[1] != '-') {
+        text.remove_prefix(1);
+    }
+    
+    int value;
+    auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (error != std::errc() || end != text.data() + text.size()) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+void CommandHandler::helpCommand(CommandArgs) {
     std::cout << "Travel Pack Tracker - CLI Usage:\n\n";
     std::cout << "Commands:\n";
     std::cout << "  add <name> <quantity> <location>    Add item to inventory\n";
@@ -21,34 +118,41 @@ void CommandHandler::helpCommand() {
     std::cout << "      Example: list home\n\n";
     std::cout << "  find <name>                         Find specific item\n";
     std::cout << "      Example: find socks\n\n";
+    std::cout << "  history                             List saved versions\n\n";
+    std::cout << "  at <version> list [location]        List items as of a saved version\n";
+    std::cout << "  at <version> find <name>            Find an item as of a saved version\n";
+    std::cout << "      Example: at 3 list suitcase\n\n";
+    std::cout << "  diff <from> [to]                    Show changes between versions\n";
+    std::cout << "      Example: diff 3\n";
+    std::cout << "      Example: diff 3 5\n\n";
+    std::cout << "  reshard <count>                     Split data across <count> files\n";
+    std::cout << "      Example: reshard 8\n\n";
     std::cout << "  help                                Show this help message\n";
 }
 
-void CommandHandler::addCommand(const std::vector<std::string>& args) {
+void CommandHandler::addCommand(CommandArgs args) {
     if (args.size() < 3) {
         std::cout << "Usage: add <name> <quantity> <location>\n";
         std::cout << "Example: add socks 2 home\n";
         return;
     }
     
-    std::string name = args[0];
-    int quantity;
+    std::string name(args[0]);
     
     // Parse quantity (handle non-numeric input)
-    try {
-        quantity = std::stoi(args[1]);
-    } catch (...) {
+    auto quantity = parseNumber(args[1]);
+    if (!quantity) {
         std::cout << "Error: Quantity must be a number\n";
         return;
     }
     
-    std::string location = args[2];
+    std::string location(args[2]);
     
-    inventory.addItem(Item(name, quantity, location));
-    std::cout << "✓ Added " << quantity << "x " << name << " at " << location << "\n";
+    inventory.addItem(Item(name, *quantity, location));
+    std::cout << "✓ Added " << *quantity << "x " << name << " at " << location << "\n";
 }
 
-void CommandHandler::removeCommand(const std::vector<std::string>& args) {
+void CommandHandler::removeCommand(CommandArgs args) {
     if (args.empty()) {
         std::cout << "Usage: remove <name> [quantity]\n";
         std::cout << "Example: remove socks\n";
@@ -56,7 +160,7 @@ void CommandHandler::removeCommand(const std::vector<std::string>& args) {
         return;
     }
     
-    std::string name = args[0];
+    std::string name(args[0]);
     
     if (args.size() == 1) {
         // Remove entire item
@@ -67,23 +171,21 @@ void CommandHandler::removeCommand(const std::vector<std::string>& args) {
         }
     } else {
         // Remove specific quantity
-        int quantity;
-        try {
-            quantity = std::stoi(args[1]);
-        } catch (...) {
+        auto quantity = parseNumber(args[1]);
+        if (!quantity) {
             std::cout << "Error: Quantity must be a number\n";
             return;
         }
         
-        if (inventory.removeItemQuantity(name, quantity)) {
-            std::cout << "✓ Removed " << quantity << "x " << name << "\n";
+        if (inventory.removeItemQuantity(name, *quantity)) {
+            std::cout << "✓ Removed " << *quantity << "x " << name << "\n";
         } else {
             std::cout << "✗ Item '" << name << "' not found\n";
         }
     }
 }
 
-void CommandHandler::moveCommand(const std::vector<std::string>& args) {
+void CommandHandler::moveCommand(CommandArgs args) {
     if (args.size() < 4) {
         std::cout << "Usage: move <name> <quantity|all> <from> <to>\n";
         std::cout << "Example: move socks 2 home suitcase\n";
@@ -91,21 +193,21 @@ void CommandHandler::moveCommand(const std::vector<std::string>& args) {
         return;
     }
     
-    std::string name = args[0];
+    std::string name(args[0]);
     int quantity = -1; // -1 means move all
     
     // Parse quantity or handle "all" keyword
     if (args[1] != "all") {
-        try {
-            quantity = std::stoi(args[1]);
-        } catch (...) {
+        auto parsed = parseNumber(args[1]);
+        if (!parsed) {
             std::cout << "Error: Quantity must be a number or 'all'\n";
             return;
         }
+        quantity = *parsed;
     }
     
-    std::string fromLoc = args[2];
-    std::string toLoc = args[3];
+    std::string fromLoc(args[2]);
+    std::string toLoc(args[3]);
     
     if (inventory.moveItem(name, fromLoc, toLoc, quantity)) {
         if (quantity == -1) {
@@ -118,26 +220,34 @@ void CommandHandler::moveCommand(const std::vector<std::string>& args) {
     }
 }
 
-void CommandHandler::listCommand(const std::vector<std::string>& args) {
+void CommandHandler::listCommand(CommandArgs args) {
+    listIn(inventory, args);
+}
+
+void CommandHandler::findCommand(CommandArgs args) {
+    findIn(inventory, args);
+}
+
+void CommandHandler::listIn(const InventoryView& view, CommandArgs args) {
     if (args.empty()) {
         // List all items
-        inventory.listItems();
+        view.listItems();
     } else {
         // List items at specific location
-        std::string location = args[0];
-        inventory.listItemsByLocation(location);
+        std::string location(args[0]);
+        view.listItemsByLocation(location);
     }
 }
 
-void CommandHandler::findCommand(const std::vector<std::string>& args) {
+void CommandHandler::findIn(const InventoryView& view, CommandArgs args) {
     if (args.empty()) {
         std::cout << "Usage: find <name>\n";
         std::cout << "Example: find socks\n";
         return;
     }
     
-    std::string name = args[0];
-    auto item = inventory.findItem(name);
+    std::string name(args[0]);
+    auto item = view.findItem(name);
     
     if (item.has_value()) {
         std::cout << "\n✓ Found: " << item->getName() << "\n";
@@ -148,6 +258,121 @@ void CommandHandler::findCommand(const std::vector<std::string>& args) {
     }
 }
 
+void CommandHandler::historyCommand(CommandArgs) {
+    if (!history.loadVersions() || !history.listVersions()) {
+        std::cout << "Error: Could not read version history\n";
+    }
+}
+
+void CommandHandler::atCommand(CommandArgs args) {
+    if (args.size() < 2 || (args[1] != "list" && args[1] != "find")) {
+        std::cout << "Usage: at <version> list [location]\n";
+        std::cout << "       at <version> find <name>\n";
+        std::cout << "Example: at 3 list suitcase\n";
+        return;
+    }
+    
+    auto version = parseNumber(args[0]);
+    if (!version) {
+        std::cout << "Error: Version must be a number\n";
+        return;
+    }
+    
+    if (!history.load()) {
+        std::cout << "Error: Could not read version history\n";
+        return;
+    }
+    
+    const Snapshot* snapshot = history.at(*version);
+    if (!snapshot) {
+        std::cout << "✗ Version " << *version << " not found. Run 'history' to see saved versions.\n";
+        return;
+    }
+    
+    // Remaining arguments go to the query, which reads the rebuilt snapshot
+    CommandArgs queryArgs = args.dropFront(2);
+    if (args[1] == "list") {
+        listIn(*snapshot, queryArgs);
+    } else {
+        findIn(*snapshot, queryArgs);
+    }
+}
+
+void CommandHandler::diffCommand(CommandArgs args) {
+    if (args.empty()) {
+        std::cout << "Usage: diff <from> [to]\n";
+        std::cout << "Example: diff 3\n";
+        std::cout << "Example: diff 3 5\n";
+        return;
+    }
+    
+    if (!history.loadVersions()) {
+        std::cout << "Error: Could not read version history\n";
+        return;
+    }
+    
+    auto from = parseNumber(args[0]);
+    auto to = args.size() > 1 ? parseNumber(args[1]) : std::optional<int>(history.latestId());
+    if (!from || !to) {
+        std::cout << "Error: Version must be a number\n";
+        return;
+    }
+    int fromId = *from;
+    int toId = *to;
+    
+    if (!history.hasVersion(fromId) || !history.hasVersion(toId)) {
+        std::cout << "✗ Version not found. Run 'history' to see saved versions.\n";
+        return;
+    }
+    
+    auto changes = history.diff(fromId, toId);
+    if (!changes) {
+        std::cout << "Error: Could not read version history\n";
+        return;
+    }
+    if (changes->empty()) {
+        std::cout << "No changes between v" << fromId << " and v" << toId << ".\n";
+        return;
+    }
+    
+    std::cout << "\nChanges from v" << fromId << " to v" << toId << ":\n";
+    std::cout << "----------------------------------------\n";
+    for (const auto &change : *changes) {
+        char marker = change.before == 0 ? '+' : (change.after == 0 ? '-' : '~');
+        std::cout << marker << " " << change.name
+                  << " at " << change.location
+                  << " (Qty: " << change.before << " -> " << change.after << ")\n";
+    }
+    std::cout << "----------------------------------------\n";
+}
+
+void CommandHandler::reshardCommand(CommandArgs args) {
+    if (args.empty()) {
+        std::cout << "Usage: reshard <count>\n";
+        std::cout << "Example: reshard 8\n";
+        std::cout << "Current shard count: " << inventory.getShardCount() << "\n";
+        return;
+    }
+    
+    auto count = parseNumber(args[0]);
+    if (!count) {
+        std::cout << "Error: Shard count must be a number\n";
+        return;
+    }
+    
+    if (*count < 1 || static_cast<std::size_t>(*count) > ShardedInventory::maxShards) {
+        std::cout << "Error: Shard count must be between 1 and " << ShardedInventory::maxShards << "\n";
+        std::cout << "Usage: reshard <count>\n";
+        return;
+    }
+    
+    if (!inventory.reshard(*count)) {
+        std::cout << "✗ Could not reshard, the inventory was left unchanged\n";
+        return;
+    }
+    std::cout << "✓ Inventory split across " << *count << " shard(s)\n";
+}
+
 bool CommandHandler::execute(int argc, char* argv[]) {
     // If no arguments provided, show help
     if (argc < 2) {
@@ -155,32 +380,19 @@ bool CommandHandler::execute(int argc, char* argv[]) {
         return false;
     }
     
-    std::string command = argv[1];
+    std::string_view command = argv[1];
     
-    // Build args vector from remaining command-line arguments
-    std::vector<std::string> args;
-    for (int i = 2; i < argc; i++) {
-        args.push_back(argv[i]);
-    }
+    // Arguments are views into argv, nothing is copied
+    CommandArgs args(std::span<char* const>(argv + 2, argc - 2));
     
     // Route to appropriate command handler
-    if (command == "add") {
-        addCommand(args);
-    } else if (command == "remove") {
-        removeCommand(args);
-    } else if (command == "move") {
-        moveCommand(args);
-    } else if (command == "list") {
-        listCommand(args);
-    } else if (command == "find") {
-        findCommand(args);
-    } else if (command == "help") {
-        helpCommand();
-    } else {
+    const CommandEntry* entry = lookupCommand(command);
+    if (!entry) {
         std::cout << "Unknown command: " << command << "\n";
         std::cout << "Run 'help' to see available commands\n";
         return false;
     }
     
+    (this->*entry->handler)(args);
     return true;
 }
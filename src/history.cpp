@@ -0,0 +1,485 @@
+#include "history.h"
+#include "atomic_file.h"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <ctime>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+namespace {
+
+std::int64_t toSeconds(std::chrono::system_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::seconds>(time.time_since_epoch()).count();
+}
+
+std::string formatTimestamp(std::int64_t timestamp) {
+    std::time_t t = static_cast<std::time_t>(timestamp);
+    std::ostringstream out;
+    out << std::put_time(std::localtime(&t), "%Y-%m-%d %H:%M");
+    return out.str();
+}
+
+json versionToJson(const Version &version) {
+    json changes = json::array();
+    for (const auto& change : version.changes) {
+        changes.push_back({
+            {"name", change.name},
+            {"location", change.location},
+            {"delta", change.delta}
+        });
+    }
+    return {{"id", version.id}, {"timestamp", version.timestamp}, {"changes", changes}};
+}
+
+Version versionFromJson(const json &j) {
+    Version version{j.at("id").get<int>(), j.at("timestamp").get<std::int64_t>(), {}, {}};
+    for (const auto& changeJson : j.at("changes")) {
+        version.changes.push_back({
+            changeJson.at("name").get<std::string>(),
+            changeJson.at("location").get<std::string>(),
+            changeJson.at("delta").get<int>()
+        });
+    }
+    return version;
+}
+
+// Applies a version's changes on top of the previous snapshot. Quantities are not
+// clamped: the live inventory keeps negative quantities, so the history does too
+Snapshot applyChanges(const Snapshot &snapshot, const std::vector<ItemDelta> &changes) {
+    Snapshot next = snapshot;
+    for (const auto &change : changes) {
+        int quantity = next.getQuantity(change.name, change.location) + change.delta;
+        next = next.withQuantity(change.name, change.location, quantity);
+    }
+    return next;
+}
+
+// Writes a text file in place of the old one, see replaceFile
+bool replaceTextFile(const std::string &filename, const std::string &contents) {
+    return replaceFile(filename, [&contents](const std::string &path) {
+        std::ofstream file(path);
+        if (!file.is_open()) {
+            std::cerr << "Error: Could not open file for writing: " << path << "\n";
+            return false;
+        }
+        file << contents;
+        file.close();
+        return static_cast<bool>(file);
+    });
+}
+
+}
+
+const Version* History::findVersion(int id) const {
+    auto it = std::lower_bound(versions.begin(), versions.end(), id,
+        [](const Version &version, int value) { return version.id < value; });
+
+    if (it != versions.end() && it->id == id) {
+        return &(*it);
+    }
+    return nullptr;
+}
+
+History::History(const std::string &baseName) : baseName(baseName) {}
+
+std::string History::baseFilename(int id) const {
+    return baseName + ".history.v" + std::to_string(id) + ".idx";
+}
+
+std::string History::logFilename() const {
+    return baseName + ".history.log";
+}
+
+bool History::exists() const {
+    // The log names the base file, so without it there is no history to read
+    std::error_code error;
+    return std::filesystem::exists(logFilename(), error);
+}
+
+bool History::readLog() {
+    if (logLoaded) {
+        return true;
+    }
+    if (unreadable) {
+        return false;
+    }
+
+    try {
+        std::ifstream file(logFilename());
+        if (!file.is_open()) {
+            throw std::runtime_error("Could not open " + logFilename());
+        }
+
+        std::vector<std::string> lines;
+        for (std::string line; std::getline(file, line);) {
+            if (!line.empty()) {
+                lines.push_back(std::move(line));
+            }
+        }
+        if (lines.empty()) {
+            throw std::runtime_error(logFilename() + " is empty");
+        }
+
+        // The first line names the base version, every other line is one version
+        json header = json::parse(lines[0]);
+        std::vector<Version> read;
+        bool torn = false;
+        for (std::size_t i = 1; i < lines.size(); i++) {
+            try {
+                read.push_back(versionFromJson(json::parse(lines[i])));
+            } catch (const std::exception&) {
+                // An interrupted append leaves a partial last line, which the next save drops
+                if (i + 1 != lines.size()) {
+                    throw;
+                }
+                torn = true;
+                break;
+            }
+            if (read.size() > 1 && read.back().id <= read[read.size() - 2].id) {
+                throw std::runtime_error("Versions in " + logFilename() + " are out of order");
+            }
+        }
+
+        baseId = header.at("base").get<int>();
+        baseTimestamp = header.at("timestamp").get<std::int64_t>();
+        savedBaseId = baseId;
+        versions = std::move(read);
+        savedVersions = versions.size();
+        logDirty = torn;
+        logLoaded = true;
+        return true;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error loading history: " << e.what() << "\n";
+        unreadable = true;
+        return false;
+    }
+}
+
+bool History::openBase() {
+    if (baseFile.isOpen()) {
+        return true;
+    }
+    if (!readLog()) {
+        return false;
+    }
+    if (!baseFile.open(baseFilename(baseId))) {
+        std::cerr << "Error loading history: Could not read " << baseFilename(baseId) << "\n";
+        unreadable = true;
+        return false;
+    }
+    return true;
+}
+
+int History::baseQuantity(const std::string &name, const std::string &location) const {
+    if (snapshotsLoaded) {
+        return base.getQuantity(name, location);
+    }
+    auto item = baseFile.find(name, location);
+    return item ? item->quantity : 0;
+}
+
+bool History::readSnapshots() {
+    if (snapshotsLoaded) {
+        return true;
+    }
+    if (!openBase()) {
+        return false;
+    }
+
+    base = Snapshot::fromItems(baseFile.getAllItems());
+
+    // Replay each version on top of the previous one
+    Snapshot current = base;
+    for (auto &version : versions) {
+        current = applyChanges(current, version.changes);
+        version.snapshot = current;
+    }
+
+    snapshotsLoaded = true;
+    return true;
+}
+
+void History::seed(const std::vector<Item> &items) {
+    baseId = 0;
+    baseTimestamp = toSeconds(std::chrono::system_clock::now());
+    base = Snapshot::fromItems(items);
+    baseFile = MappedInventory();
+    versions.clear();
+    logLoaded = true;
+    snapshotsLoaded = true;
+    unreadable = false;
+    savedVersions = 0;
+    logDirty = true;
+    baseDirty = true;
+}
+
+bool History::loadVersions() {
+    return readLog();
+}
+
+bool History::load() {
+    return readSnapshots();
+}
+
+bool History::commit(const std::vector<ItemDelta> &deltas) {
+    if (deltas.empty() || !readLog()) {
+        return false;
+    }
+
+    // Sum the deltas per (name, location) so each pair appears once in the version
+    std::map<std::pair<std::string, std::string>, int> totals;
+    for (const auto &delta : deltas) {
+        totals[{delta.name, delta.location}] += delta.delta;
+    }
+
+    std::vector<ItemDelta> changes;
+    for (const auto &[key, delta] : totals) {
+        if (delta != 0) {
+            changes.push_back({key.first, key.second, delta});
+        }
+    }
+
+    if (changes.empty()) {
+        return false;
+    }
+
+    Version version{latestId() + 1, toSeconds(std::chrono::system_clock::now()), std::move(changes), {}};
+    if (snapshotsLoaded) {
+        version.snapshot = applyChanges(*at(latestId()), version.changes);
+    }
+    versions.push_back(std::move(version));
+    return true;
+}
+
+void History::applyRetention(const RetentionPolicy &policy, std::chrono::system_clock::time_point now) {
+    if (!logLoaded || unreadable) {
+        return;
+    }
+
+    const std::int64_t secondsPerDay = 24 * 60 * 60;
+    const std::int64_t compactBefore = toSeconds(now - policy.compactAfter);
+    const std::int64_t dropBefore = toSeconds(now - policy.maxAge);
+
+    // Compact: merge old versions from the same day into the last one of that day
+    std::vector<Version> kept;
+    kept.reserve(versions.size());
+    for (auto &version : versions) {
+        if (!kept.empty() && version.timestamp < compactBefore
+            && kept.back().timestamp / secondsPerDay == version.timestamp / secondsPerDay) {
+            std::map<std::pair<std::string, std::string>, int> merged;
+            for (const auto &change : kept.back().changes) {
+                merged[{change.name, change.location}] += change.delta;
+            }
+            for (const auto &change : version.changes) {
+                merged[{change.name, change.location}] += change.delta;
+            }
+
+            version.changes.clear();
+            for (const auto &[key, delta] : merged) {
+                if (delta != 0) {
+                    version.changes.push_back({key.first, key.second, delta});
+                }
+            }
+            kept.back() = std::move(version);
+            logDirty = true;
+        } else {
+            kept.push_back(std::move(version));
+        }
+    }
+    versions = std::move(kept);
+
+    // Drop: fold the oldest versions into the base snapshot
+    auto foldCount = [&]() {
+        std::size_t drop = 0;
+        if (versions.size() > policy.maxVersions) {
+            // Fold a few extra so the base file is not rewritten on every commit
+            drop = versions.size() - (policy.maxVersions - std::min(policy.foldSlack, policy.maxVersions));
+        }
+        while (drop < versions.size() && versions[drop].timestamp < dropBefore) {
+            drop++;
+        }
+        return drop;
+    };
+
+    // Folding needs the snapshots
+    std::size_t drop = foldCount();
+    if (drop > 0 && !readSnapshots()) {
+        return;
+    }
+
+    if (drop > 0) {
+        const Version &newBase = versions[drop - 1];
+        baseId = newBase.id;
+        baseTimestamp = newBase.timestamp;
+        base = newBase.snapshot;
+        baseFile = MappedInventory();
+        versions.erase(versions.begin(), versions.begin() + drop);
+        logDirty = true;
+        baseDirty = true;
+    }
+}
+
+const Snapshot* History::at(int id) const {
+    if (id == baseId) {
+        return &base;
+    }
+    const Version* version = findVersion(id);
+    return version ? &version->snapshot : nullptr;
+}
+
+int History::latestId() const {
+    return versions.empty() ? baseId : versions.back().id;
+}
+
+bool History::hasVersion(int id) const {
+    return id == baseId || findVersion(id) != nullptr;
+}
+
+std::optional<std::vector<ItemDiff>> History::diff(int fromId, int toId) {
+    if (!hasVersion(fromId) || !hasVersion(toId) || (!snapshotsLoaded && !openBase())) {
+        return std::nullopt;
+    }
+
+    // Only pairs touched by versions between the two ids can differ
+    int low = std::min(fromId, toId);
+    int high = std::max(fromId, toId);
+    std::map<std::pair<std::string, std::string>, std::pair<int, int>> touched;
+    for (const auto &version : versions) {
+        if (version.id > low && version.id <= high) {
+            for (const auto &change : version.changes) {
+                touched.try_emplace({change.name, change.location}, 0, 0);
+            }
+        }
+    }
+
+    // Start each pair from its base quantity and follow the log up to both versions
+    for (auto &[key, quantities] : touched) {
+        int quantity = baseQuantity(key.first, key.second);
+        quantities = {quantity, quantity};
+    }
+    for (const auto &version : versions) {
+        if (version.id > high) {
+            break;
+        }
+        for (const auto &change : version.changes) {
+            auto it = touched.find({change.name, change.location});
+            if (it == touched.end()) continue;
+            if (version.id <= low) {
+                it->second.first += change.delta;
+            }
+            it->second.second += change.delta;
+        }
+    }
+
+    std::vector<ItemDiff> result;
+    for (const auto &[key, quantities] : touched) {
+        int before = fromId <= toId ? quantities.first : quantities.second;
+        int after = fromId <= toId ? quantities.second : quantities.first;
+        if (before != after) {
+            result.push_back({key.first, key.second, before, after});
+        }
+    }
+    return result;
+}
+
+bool History::listVersions() {
+    if (!snapshotsLoaded && !openBase()) {
+        return false;
+    }
+
+    // Item counts follow from the base count and the entries each version adds or removes
+    int count = snapshotsLoaded ? base.getTotalItems() : baseFile.getTotalItems();
+    std::map<std::pair<std::string, std::string>, int> quantities;
+
+    std::cout << "\nVersion History:\n";
+    std::cout << "----------------------------------------\n";
+    std::cout << "- v" << baseId << " (" << formatTimestamp(baseTimestamp)
+              << ", " << count << " items) [base]\n";
+    for (const auto &version : versions) {
+        for (const auto &change : version.changes) {
+            auto [it, inserted] = quantities.try_emplace({change.name, change.location}, 0);
+            if (inserted) {
+                it->second = baseQuantity(change.name, change.location);
+            }
+            int before = it->second;
+            it->second += change.delta;
+            count += (before == 0) - (it->second == 0);
+        }
+        std::cout << "- v" << version.id << " (" << formatTimestamp(version.timestamp)
+                  << ", " << version.changes.size() << " changes, "
+                  << count << " items)\n";
+    }
+    std::cout << "----------------------------------------\n";
+    return true;
+}
+
+bool History::isModified() const {
+    return !unreadable && (baseDirty || logDirty || savedVersions < versions.size());
+}
+
+bool History::save() {
+    if (unreadable) {
+        return false;
+    }
+
+    try {
+        // The base is written under its own name first; the log switches to it when rewritten
+        if (baseDirty) {
+            std::vector<Item> baseItems = base.getAllItems();
+            bool written = replaceFile(baseFilename(baseId), [&baseItems](const std::string &path) {
+                return MappedInventory::write(path, baseItems);
+            });
+            if (!written) {
+                return false;
+            }
+            baseDirty = false;
+        }
+
+        if (logDirty) {
+            std::string contents = json{{"base", baseId}, {"timestamp", baseTimestamp}}.dump() + "\n";
+            for (const auto& version : versions) {
+                contents += versionToJson(version).dump() + "\n";
+            }
+            if (!replaceTextFile(logFilename(), contents)) {
+                return false;
+            }
+            logDirty = false;
+
+            // Nothing refers to the previous base file any more
+            if (savedBaseId && *savedBaseId != baseId) {
+                std::error_code error;
+                std::filesystem::remove(baseFilename(*savedBaseId), error);
+            }
+            savedBaseId = baseId;
+        } else if (savedVersions < versions.size()) {
+            // New versions only: append one line each
+            std::ofstream file(logFilename(), std::ios::app);
+            if (!file.is_open()) {
+                std::cerr << "Error: Could not open file for writing: " << logFilename() << "\n";
+                return false;
+            }
+            for (std::size_t i = savedVersions; i < versions.size(); i++) {
+                file << versionToJson(versions[i]).dump() << "\n";
+            }
+            file.close();
+            if (!file) {
+                std::cerr << "Error: Could not write " << logFilename() << "\n";
+                return false;
+            }
+        }
+        savedVersions = versions.size();
+        return true;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error saving history: " << e.what() << "\n";
+        return false;
+    }
+}
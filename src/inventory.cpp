@@ -1,12 +1,22 @@
 #include "inventory.h"
+#include "block_codec.h"
 #include <iostream>
 #include <algorithm>
 #include <fstream>
+#include <iterator>
 #include <nlohmann/json.hpp>
 
 using json = nlohmann::json;
 
+void Inventory::recordChange(const std::string &name, const std::string &location, int delta) {
+    if (delta != 0) {
+        changes.push_back({name, location, delta});
+    }
+}
+
 void Inventory::addItem(const Item &item) {
+    recordChange(item.getName(), item.getLocation(), item.getQuantity());
+    
     // Check if item already exists at this location
     auto existingItem = findItemPtr(item.getName());
     if (existingItem && existingItem->getLocation() == item.getLocation()) {
@@ -23,6 +33,7 @@ bool Inventory::removeItem(const std::string &name) {
         [&name](const Item &item) { return item.getName() == name; });
     
     if (it != items.end()) {
+        recordChange(it->getName(), it->getLocation(), -it->getQuantity());
         items.erase(it);
         return true;
     }
@@ -32,7 +43,9 @@ bool Inventory::removeItem(const std::string &name) {
 bool Inventory::removeItemQuantity(const std::string &name, int amount) {
     auto item = findItemPtr(name);
     if (item) {
+        int before = item->getQuantity();
         item->removeQuantity(amount);
+        recordChange(name, item->getLocation(), item->getQuantity() - before);
         if (item->getQuantity() <= 0) {
             removeItem(name);
         }
@@ -64,6 +77,7 @@ Item* Inventory::findItemPtr(const std::string &name) {
 bool Inventory::updateItemQuantity(const std::string &name, int newQuantity) {
     auto item = findItemPtr(name);
     if (item) {
+        recordChange(name, item->getLocation(), newQuantity - item->getQuantity());
         item->setQuantity(newQuantity);
         return true;
     }
@@ -73,6 +87,8 @@ bool Inventory::updateItemQuantity(const std::string &name, int newQuantity) {
 bool Inventory::updateItemLocation(const std::string &name, const std::string &newLocation) {
     auto item = findItemPtr(name);
     if (item) {
+        recordChange(name, item->getLocation(), -item->getQuantity());
+        recordChange(name, newLocation, item->getQuantity());
         item->setLocation(newLocation);
         return true;
     }
@@ -84,9 +100,13 @@ bool Inventory::moveItem(const std::string &name, const std::string &fromLoc, co
     if (item && item->getLocation() == fromLoc) {
         if (quantity == -1 || quantity >= item->getQuantity()) {
             // Move all items to new location
+            recordChange(name, fromLoc, -item->getQuantity());
+            recordChange(name, toLoc, item->getQuantity());
             item->setLocation(toLoc);
         } else {
             // Split item - move only specified quantity
+            recordChange(name, fromLoc, -quantity);
+            recordChange(name, toLoc, quantity);
             item->removeQuantity(quantity);
             items.push_back(Item(name, quantity, toLoc));
         }
@@ -105,7 +125,7 @@ std::vector<Item> Inventory::getItemsByLocation(const std::string &location) con
     return result;
 }
 
-const std::vector<Item>& Inventory::getAllItems() const {
+std::vector<Item> Inventory::getAllItems() const {
     return items;
 }
 
@@ -113,56 +133,29 @@ int Inventory::getTotalItems() const {
     return items.size();
 }
 
-void Inventory::listItems() const {
-    if (items.empty()) {
-        std::cout << "No items in inventory.\n";
-        return;
-    }
-    
-    std::cout << "\nAll Items:\n";
-    std::cout << "----------------------------------------\n";
-    for (const auto &item : items) {
-        std::cout << "- " << item.getName() 
-                  << " (Qty: " << item.getQuantity() 
-                  << ", Location: " << item.getLocation() << ")\n";
-    }
-    std::cout << "----------------------------------------\n";
-}
-
-void Inventory::listItemsByLocation(const std::string &location) const {
-    auto locationItems = getItemsByLocation(location);
-    
-    if (locationItems.empty()) {
-        std::cout << "No items at " << location << ".\n";
-        return;
-    }
-    
-    std::cout << "\nItems at " << location << ":\n";
-    std::cout << "----------------------------------------\n";
-    for (const auto &item : locationItems) {
-        std::cout << "- " << item.getName() 
-                  << " (Qty: " << item.getQuantity() << ")\n";
-    }
-    std::cout << "----------------------------------------\n";
-}
-
-bool Inventory::saveToFile(const std::string& filename) const {
+bool Inventory::saveToFile(const std::string& filename, StorageFormat format) const {
     try {
-        json j = json::array();
-        
-        // Convert each item to JSON
-        for (const auto& item : items) {
-            j.push_back(item.toJson());
+        std::string contents;
+        if (format == StorageFormat::Compressed) {
+            contents = BlockCodec::encode(items);
+        } else {
+            json j = json::array();
+            
+            // Convert each item to JSON
+            for (const auto& item : items) {
+                j.push_back(item.toJson());
+            }
+            contents = j.dump(4);
         }
         
         // Open file for writing
-        std::ofstream file(filename);
+        std::ofstream file(filename, std::ios::binary);
         if (!file.is_open()) {
             std::cerr << "Error: Could not open file for writing: " << filename << "\n";
             return false;
         }
         
-        file << j.dump(4);
+        file << contents;
         file.close();
         return true;
         
@@ -174,22 +167,28 @@ bool Inventory::saveToFile(const std::string& filename) const {
 
 bool Inventory::loadFromFile(const std::string& filename) {
     try {
-        std::ifstream file(filename);
+        std::ifstream file(filename, std::ios::binary);
         if (!file.is_open()) {
             return false;
         }
         
-        // Parse JSON from file
-        json j;
-        file >> j;
+        std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
         file.close();
         
-        // Clear existing items and load from JSON
-        items.clear();
-        for (const auto& itemJson : j) {
-            items.push_back(Item::fromJson(itemJson));
+        // Compressed files are recognised by their magic bytes, anything else is JSON
+        std::vector<Item> loaded;
+        if (BlockCodec::isCompressed(contents)) {
+            loaded = BlockCodec::decode(contents);
+        } else {
+            json j = json::parse(contents);
+            for (const auto& itemJson : j) {
+                loaded.push_back(Item::fromJson(itemJson));
+            }
         }
         
+        // Replace existing items only once the whole file was read successfully
+        loadItems(std::move(loaded));
+        
         return true;
         
     } catch (const std::exception& e) {
@@ -197,3 +196,14 @@ bool Inventory::loadFromFile(const std::string& filename) {
         return false;
     }
 }
+
+void Inventory::loadItems(std::vector<Item> newItems) {
+    items = std::move(newItems);
+    changes.clear();
+}
+
+std::vector<ItemDelta> Inventory::takeChanges() {
+    std::vector<ItemDelta> taken;
+    taken.swap(changes);
+    return taken;
+}
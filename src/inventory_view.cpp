@@ -0,0 +1,37 @@
+#include "inventory_view.h"
+#include <iostream>
+
+void InventoryView::listItems() const {
+    auto items = getAllItems();
+    
+    if (items.empty()) {
+        std::cout << "No items in inventory.\n";
+        return;
+    }
+    
+    std::cout << "\nAll Items:\n";
+    std::cout << "----------------------------------------\n";
+    for (const auto &item : items) {
+        std::cout << "- " << item.getName() 
+                  << " (Qty: " << item.getQuantity() 
+                  << ", Location: " << item.getLocation() << ")\n";
+    }
+    std::cout << "----------------------------------------\n";
+}
+
+void InventoryView::listItemsByLocation(const std::string &location) const {
+    auto locationItems = getItemsByLocation(location);
+    
+    if (locationItems.empty()) {
+        std::cout << "No items at " << location << ".\n";
+        return;
+    }
+    
+    std::cout << "\nItems at " << location << ":\n";
+    std::cout << "----------------------------------------\n";
+    for (const auto &item : locationItems) {
+        std::cout << "- " << item.getName() 
+                  << " (Qty: " << item.getQuantity() << ")\n";
+    }
+    std::cout << "----------------------------------------\n";
+}
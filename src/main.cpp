@@ -1,15 +1,40 @@
-#include "inventory.h"
+#include "sharded_inventory.h"
+#include "history.h"
 #include "commands.h"
+#include <cstdlib>
 #include <iostream>
 
 int main(int argc, char* argv[]) {
-    const std::string filename = "inventory.json";
+    // Opt in to block-compressed storage with TRAVEL_PACK_COMPRESS=1
+    const char* compressSetting = std::getenv("TRAVEL_PACK_COMPRESS");
+    const bool compress = compressSetting && *compressSetting && std::string(compressSetting) != "0";
+    const StorageFormat format = compress ? StorageFormat::Compressed : StorageFormat::Json;
     
-    Inventory inventory;
-    inventory.loadFromFile(filename);
-    CommandHandler commandHandler(inventory);
+    // Opt in to the memory-mapped find index with TRAVEL_PACK_INDEX=1
+    const char* indexSetting = std::getenv("TRAVEL_PACK_INDEX");
+    const bool useIndex = indexSetting && *indexSetting && std::string(indexSetting) != "0";
+    
+    // Shards are read lazily, so commands only load the data files they touch
+    ShardedInventory inventory("inventory", format, useIndex);
+    
+    // History files are read only by commands and commits that need them
+    History history("inventory");
+    
+    // Start a fresh history from the current contents if none exists yet
+    if (!history.exists()) {
+        history.seed(inventory.getAllItems());
+    }
+    
+    CommandHandler commandHandler(inventory, history);
     commandHandler.execute(argc, argv);
-    inventory.saveToFile(filename);
+    
+    history.commit(inventory.takeChanges());
+    history.applyRetention(RetentionPolicy{});
+    
+    inventory.save();
+    if (history.isModified()) {
+        history.save();
+    }
     
     return 0;
 }
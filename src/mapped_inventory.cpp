@@ -0,0 +1,317 @@
+#include "mapped_inventory.h"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <unordered_map>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+struct MappedInventory::Header {
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t byteOrder;
+    std::uint32_t slotCount;
+    std::uint64_t itemCount;
+    std::uint64_t sourceSize;
+    std::int64_t sourceModified;
+    std::int64_t sourceChanged;
+    std::uint64_t slotsOffset;
+    std::uint64_t recordsOffset;
+    std::uint64_t stringsOffset;
+    std::uint64_t stringsSize;
+};
+
+struct MappedInventory::Slot {
+    std::uint32_t hash;
+    std::uint32_t record;
+};
+
+struct MappedInventory::Record {
+    std::uint32_t nameOffset;
+    std::uint32_t nameLength;
+    std::uint32_t locationOffset;
+    std::uint32_t locationLength;
+    std::int32_t quantity;
+    std::uint32_t reserved;
+};
+
+namespace {
+
+constexpr char indexMagic[4] = {'T', 'P', 'K', 'X'};
+constexpr std::uint32_t indexVersion = 2;
+constexpr std::uint32_t byteOrderMarker = 0x01020304;
+
+std::uint32_t nameHash(std::string_view name) {
+    std::uint32_t hash = 2166136261u;
+    for (unsigned char c : name) {
+        hash ^= c;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+std::int64_t nanoseconds(const struct timespec &time) {
+    return static_cast<std::int64_t>(time.tv_sec) * 1000000000 + time.tv_nsec;
+}
+
+}
+
+MappedInventory::~MappedInventory() {
+    close();
+}
+
+MappedInventory::MappedInventory(MappedInventory&& other) noexcept
+    : data(std::exchange(other.data, nullptr)), size(std::exchange(other.size, 0)) {}
+
+MappedInventory& MappedInventory::operator=(MappedInventory&& other) noexcept {
+    if (this != &other) {
+        close();
+        data = std::exchange(other.data, nullptr);
+        size = std::exchange(other.size, 0);
+    }
+    return *this;
+}
+
+void MappedInventory::close() {
+    if (data) {
+        munmap(const_cast<char*>(data), size);
+        data = nullptr;
+        size = 0;
+    }
+}
+
+const MappedInventory::Header* MappedInventory::header() const {
+    return reinterpret_cast<const Header*>(data);
+}
+
+const MappedInventory::Slot* MappedInventory::slots() const {
+    return reinterpret_cast<const Slot*>(data + header()->slotsOffset);
+}
+
+const MappedInventory::Record* MappedInventory::records() const {
+    return reinterpret_cast<const Record*>(data + header()->recordsOffset);
+}
+
+std::optional<SourceStamp> MappedInventory::stamp(const std::string &filename) {
+    struct stat info;
+    if (stat(filename.c_str(), &info) != 0) {
+        return std::nullopt;
+    }
+    return SourceStamp{static_cast<std::uint64_t>(info.st_size), nanoseconds(info.st_mtim), nanoseconds(info.st_ctim)};
+}
+
+bool MappedInventory::write(const std::string &filename, const std::vector<Item> &items, const SourceStamp &source) {
+    // Keep the table at most half full so probe sequences stay short
+    std::uint32_t slotCount = 16;
+    while (slotCount < items.size() * 2) {
+        slotCount *= 2;
+    }
+
+    std::string strings;
+    std::unordered_map<std::string, std::uint32_t> stringOffsets;
+    auto intern = [&strings, &stringOffsets](const std::string &value) {
+        auto [it, inserted] = stringOffsets.try_emplace(value, static_cast<std::uint32_t>(strings.size()));
+        if (inserted) {
+            strings += value;
+        }
+        return it->second;
+    };
+
+    std::vector<Record> recordTable;
+    std::vector<Slot> slotTable(slotCount, Slot{0, 0});
+    recordTable.reserve(items.size());
+    for (const auto &item : items) {
+        std::string name = item.getName();
+        std::string location = item.getLocation();
+        recordTable.push_back({
+            intern(name), static_cast<std::uint32_t>(name.size()),
+            intern(location), static_cast<std::uint32_t>(location.size()),
+            item.getQuantity(), 0
+        });
+
+        std::uint32_t hash = nameHash(name);
+        std::uint32_t slot = hash & (slotCount - 1);
+        while (slotTable[slot].record != 0) {
+            slot = (slot + 1) & (slotCount - 1);
+        }
+        slotTable[slot] = {hash, static_cast<std::uint32_t>(recordTable.size())};
+    }
+
+    if (strings.size() > UINT32_MAX) {
+        std::cerr << "Error: Inventory too large to index\n";
+        return false;
+    }
+
+    Header head{};
+    std::memcpy(head.magic, indexMagic, sizeof(indexMagic));
+    head.version = indexVersion;
+    head.byteOrder = byteOrderMarker;
+    head.slotCount = slotCount;
+    head.itemCount = recordTable.size();
+    head.sourceSize = source.size;
+    head.sourceModified = source.modified;
+    head.sourceChanged = source.changed;
+    head.slotsOffset = sizeof(Header);
+    head.recordsOffset = head.slotsOffset + slotTable.size() * sizeof(Slot);
+    head.stringsOffset = head.recordsOffset + recordTable.size() * sizeof(Record);
+    head.stringsSize = strings.size();
+
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open file for writing: " << filename << "\n";
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char*>(&head), sizeof(head));
+    file.write(reinterpret_cast<const char*>(slotTable.data()), slotTable.size() * sizeof(Slot));
+    file.write(reinterpret_cast<const char*>(recordTable.data()), recordTable.size() * sizeof(Record));
+    file.write(strings.data(), strings.size());
+    file.close();
+    return static_cast<bool>(file);
+}
+
+bool MappedInventory::open(const std::string &filename) {
+    close();
+
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < sizeof(Header)) {
+        ::close(fd);
+        return false;
+    }
+
+    // The mapping stays valid after the descriptor is closed
+    void* mapping = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+    data = static_cast<const char*>(mapping);
+    size = info.st_size;
+
+    // Check that every section lies inside the file; records are checked as they are read
+    const Header* head = header();
+    std::uint64_t slotBytes = static_cast<std::uint64_t>(head->slotCount) * sizeof(Slot);
+    bool valid = std::memcmp(head->magic, indexMagic, sizeof(indexMagic)) == 0
+        && head->version == indexVersion
+        && head->byteOrder == byteOrderMarker
+        && head->slotCount != 0 && (head->slotCount & (head->slotCount - 1)) == 0
+        && head->itemCount < head->slotCount
+        && head->slotsOffset == sizeof(Header)
+        && head->recordsOffset == head->slotsOffset + slotBytes
+        && head->stringsOffset == head->recordsOffset + head->itemCount * sizeof(Record)
+        && head->stringsOffset <= size
+        && head->stringsSize == size - head->stringsOffset;
+    if (!valid) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool MappedInventory::isOpen() const {
+    return data != nullptr;
+}
+
+std::optional<SourceStamp> MappedInventory::getSource() const {
+    if (!data) {
+        return std::nullopt;
+    }
+    return SourceStamp{header()->sourceSize, header()->sourceModified, header()->sourceChanged};
+}
+
+std::optional<MappedItem> MappedInventory::itemAt(std::uint64_t index) const {
+    const Header* head = header();
+    if (index >= head->itemCount) {
+        return std::nullopt;
+    }
+
+    const Record &record = records()[index];
+    if (static_cast<std::uint64_t>(record.nameOffset) + record.nameLength > head->stringsSize
+        || static_cast<std::uint64_t>(record.locationOffset) + record.locationLength > head->stringsSize) {
+        return std::nullopt;
+    }
+
+    const char* strings = data + head->stringsOffset;
+    return MappedItem{
+        std::string_view(strings + record.nameOffset, record.nameLength),
+        record.quantity,
+        std::string_view(strings + record.locationOffset, record.locationLength)
+    };
+}
+
+std::optional<MappedItem> MappedInventory::probe(std::string_view name, const std::string_view *location) const {
+    if (!data) {
+        return std::nullopt;
+    }
+
+    const std::uint32_t mask = header()->slotCount - 1;
+    const std::uint32_t hash = nameHash(name);
+    const Slot* table = slots();
+
+    // Linear probing; the table is never full, so an empty slot always ends the search
+    for (std::uint32_t slot = hash & mask, probes = 0; probes <= mask; slot = (slot + 1) & mask, probes++) {
+        if (table[slot].record == 0) {
+            break;
+        }
+        if (table[slot].hash != hash) {
+            continue;
+        }
+
+        auto item = itemAt(table[slot].record - 1);
+        if (item && item->name == name && (!location || item->location == *location)) {
+            return item;
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<MappedItem> MappedInventory::find(std::string_view name) const {
+    return probe(name, nullptr);
+}
+
+std::optional<MappedItem> MappedInventory::find(std::string_view name, std::string_view location) const {
+    return probe(name, &location);
+}
+
+std::optional<Item> MappedInventory::findItem(const std::string &name) const {
+    auto item = find(name);
+    if (item) {
+        return Item(std::string(item->name), item->quantity, std::string(item->location));
+    }
+    return std::nullopt;
+}
+
+std::vector<Item> MappedInventory::getAllItems() const {
+    std::vector<Item> result;
+    for (std::uint64_t i = 0, count = getTotalItems(); i < count; i++) {
+        auto item = itemAt(i);
+        if (item) {
+            result.push_back(Item(std::string(item->name), item->quantity, std::string(item->location)));
+        }
+    }
+    return result;
+}
+
+std::vector<Item> MappedInventory::getItemsByLocation(const std::string &location) const {
+    std::vector<Item> result;
+    for (std::uint64_t i = 0, count = getTotalItems(); i < count; i++) {
+        auto item = itemAt(i);
+        if (item && item->location == location) {
+            result.push_back(Item(std::string(item->name), item->quantity, location));
+        }
+    }
+    return result;
+}
+
+int MappedInventory::getTotalItems() const {
+    return data ? static_cast<int>(header()->itemCount) : 0;
+}
+
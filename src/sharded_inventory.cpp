@@ -0,0 +1,384 @@
+#include "sharded_inventory.h"
+#include "atomic_file.h"
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+namespace {
+
+StorageFormat otherFormat(StorageFormat format) {
+    return format == StorageFormat::Json ? StorageFormat::Compressed : StorageFormat::Json;
+}
+
+}
+
+ShardedInventory::ShardedInventory(const std::string &baseName, StorageFormat format, bool useIndex)
+    : baseName(baseName), format(format), useIndex(useIndex) {
+    std::ifstream file(manifestFilename());
+    if (file.is_open()) {
+        try {
+            json j;
+            file >> j;
+            shardCount = std::max<std::size_t>(j.at("shards").get<std::size_t>(), 1);
+            if (shardCount > maxShards) {
+                shardCount = 1;
+                throw std::out_of_range("shard count above " + std::to_string(maxShards));
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Error loading shard manifest: " << e.what() << "\n";
+            manifestUnreadable = true;
+        }
+    }
+    shards.resize(shardCount);
+}
+
+std::string ShardedInventory::shardFilename(std::size_t index, std::size_t count, StorageFormat fileFormat) const {
+    std::string extension = fileFormat == StorageFormat::Compressed ? ".tpk" : ".json";
+    if (count == 1) {
+        return baseName + extension;
+    }
+    // The shard count is part of the name, so files from different layouts never collide
+    return baseName + "." + std::to_string(index) + "-of-" + std::to_string(count) + extension;
+}
+
+std::string ShardedInventory::indexFilename(std::size_t index, std::size_t count) const {
+    if (count == 1) {
+        return baseName + ".idx";
+    }
+    return baseName + "." + std::to_string(index) + "-of-" + std::to_string(count) + ".idx";
+}
+
+bool ShardedInventory::openIndex(std::size_t index, MappedInventory &mapped) const {
+    // The index must have been built from the data file exactly as it is now
+    auto source = MappedInventory::stamp(shardFilename(index, shardCount, format));
+    return source && mapped.open(indexFilename(index, shardCount)) && mapped.getSource() == source;
+}
+
+std::string ShardedInventory::manifestFilename() const {
+    return baseName + ".shards.json";
+}
+
+std::size_t ShardedInventory::shardFor(const std::string &name, std::size_t count) const {
+    // FNV-1a: unlike std::hash, stable across builds and platforms
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : name) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash % count;
+}
+
+ShardedInventory::Shard& ShardedInventory::loadShard(std::size_t index) const {
+    Shard &shard = shards[index];
+    if (!shard.loaded) {
+        std::string filename = shardFilename(index, shardCount, format);
+        std::string otherFilename = shardFilename(index, shardCount, otherFormat(format));
+        std::error_code error;
+        bool exists = std::filesystem::exists(filename, error);
+        bool otherExists = !exists && std::filesystem::exists(otherFilename, error);
+        
+        if (exists) {
+            shard.unreadable = !shard.inventory.loadFromFile(filename);
+        } else if (otherExists) {
+            shard.migrating = shard.inventory.loadFromFile(otherFilename);
+            shard.unreadable = !shard.migrating;
+        }
+        if (shard.unreadable) {
+            std::cerr << "Error: Shard " << index << " could not be read and will not be modified\n";
+        }
+        if (!exists && !shard.migrating) {
+            // Missing or unreadable data, so there is nothing to index
+            shard.indexStale = false;
+        }
+        shard.loaded = true;
+    }
+    return shard;
+}
+
+void ShardedInventory::forEachShard(const std::function<void(std::size_t)> &work) const {
+    // Hand out contiguous runs of shards to one task per hardware thread
+    std::size_t taskCount = std::min<std::size_t>(shards.size(), std::max(1u, std::thread::hardware_concurrency()));
+    std::vector<std::future<void>> tasks;
+    for (std::size_t t = 0; t < taskCount; t++) {
+        std::size_t first = shards.size() * t / taskCount;
+        std::size_t last = shards.size() * (t + 1) / taskCount;
+        tasks.push_back(std::async(std::launch::async, [&work, first, last] {
+            for (std::size_t i = first; i < last; i++) {
+                work(i);
+            }
+        }));
+    }
+    for (auto &task : tasks) {
+        task.get();
+    }
+}
+
+void ShardedInventory::loadAllShards() const {
+    forEachShard([this](std::size_t i) { loadShard(i); });
+}
+
+std::size_t ShardedInventory::getShardCount() const {
+    return shardCount;
+}
+
+bool ShardedInventory::reshard(std::size_t count) {
+    if (count == 0 || count > maxShards) {
+        return false;
+    }
+    if (manifestUnreadable) {
+        std::cerr << "Error: Cannot reshard while the shard manifest is unreadable\n";
+        return false;
+    }
+    if (count == shardCount) {
+        return true;
+    }
+
+    try {
+        std::vector<Item> items = getAllItems();
+        for (std::size_t i = 0; i < shards.size(); i++) {
+            if (shards[i].unreadable) {
+                std::cerr << "Error: Cannot reshard while shard " << i << " is unreadable\n";
+                return false;
+            }
+        }
+
+        // Build the new layout completely before touching the current one
+        std::vector<Shard> newShards(count);
+        std::vector<std::vector<Item>> parts(count);
+        for (auto &item : items) {
+            parts[shardFor(item.getName(), count)].push_back(std::move(item));
+        }
+
+        std::vector<std::string> oldFiles;
+        for (std::size_t i = 0; i < shardCount; i++) {
+            oldFiles.push_back(shardFilename(i, shardCount, StorageFormat::Json));
+            oldFiles.push_back(shardFilename(i, shardCount, StorageFormat::Compressed));
+            oldFiles.push_back(indexFilename(i, shardCount));
+        }
+
+        // Empty shards are not written, since a missing file reads as an empty shard;
+        // any file left at their names by an interrupted reshard is removed instead
+        std::vector<std::string> emptyFiles;
+        for (std::size_t i = 0; i < count; i++) {
+            if (parts[i].empty()) {
+                emptyFiles.push_back(shardFilename(i, count, StorageFormat::Json));
+                emptyFiles.push_back(shardFilename(i, count, StorageFormat::Compressed));
+                emptyFiles.push_back(indexFilename(i, count));
+            }
+            newShards[i].dirty = !parts[i].empty();
+            newShards[i].inventory.loadItems(std::move(parts[i]));
+            newShards[i].loaded = true;
+        }
+
+        // Keep this run's changes; moving items between shards is not itself a change
+        pendingChanges = takeChanges();
+        staleFiles.insert(staleFiles.end(), oldFiles.begin(), oldFiles.end());
+        clearedFiles = std::move(emptyFiles);
+        shards = std::move(newShards);
+        shardCount = count;
+        manifestDirty = true;
+        return true;
+
+    } catch (const std::bad_alloc&) {
+        std::cerr << "Error: Not enough memory to reshard into " << count << " shards\n";
+        return false;
+    }
+}
+
+void ShardedInventory::addItem(const Item &item) {
+    Shard &shard = loadShard(shardFor(item.getName(), shardCount));
+    shard.inventory.addItem(item);
+    shard.dirty = true;
+}
+
+bool ShardedInventory::removeItem(const std::string &name) {
+    Shard &shard = loadShard(shardFor(name, shardCount));
+    bool removed = shard.inventory.removeItem(name);
+    shard.dirty |= removed;
+    return removed;
+}
+
+bool ShardedInventory::removeItemQuantity(const std::string &name, int amount) {
+    Shard &shard = loadShard(shardFor(name, shardCount));
+    bool updated = shard.inventory.removeItemQuantity(name, amount);
+    shard.dirty |= updated;
+    return updated;
+}
+
+bool ShardedInventory::moveItem(const std::string &name, const std::string &fromLoc,
+                                const std::string &toLoc, int quantity) {
+    Shard &shard = loadShard(shardFor(name, shardCount));
+    bool moved = shard.inventory.moveItem(name, fromLoc, toLoc, quantity);
+    shard.dirty |= moved;
+    return moved;
+}
+
+std::vector<Item> ShardedInventory::getAllItems() const {
+    loadAllShards();
+
+    std::vector<Item> result;
+    for (const auto &shard : shards) {
+        const auto &items = shard.inventory.getAllItems();
+        result.insert(result.end(), items.begin(), items.end());
+    }
+    return result;
+}
+
+std::optional<Item> ShardedInventory::findItem(const std::string &name) const {
+    std::size_t index = shardFor(name, shardCount);
+    if (useIndex && !shards[index].loaded) {
+        MappedInventory mapped;
+        if (openIndex(index, mapped)) {
+            return mapped.findItem(name);
+        }
+        // Rebuild the missing or outdated index on the next save
+        shards[index].indexStale = true;
+    }
+    return loadShard(index).inventory.findItem(name);
+}
+
+std::vector<Item> ShardedInventory::getItemsByLocation(const std::string &location) const {
+    // Fan out: each task loads and filters a run of shards
+    std::vector<std::vector<Item>> found(shards.size());
+    forEachShard([this, &found, &location](std::size_t i) {
+        found[i] = loadShard(i).inventory.getItemsByLocation(location);
+    });
+
+    std::vector<Item> result;
+    for (auto &items : found) {
+        std::move(items.begin(), items.end(), std::back_inserter(result));
+    }
+    return result;
+}
+
+int ShardedInventory::getTotalItems() const {
+    loadAllShards();
+
+    int total = 0;
+    for (const auto &shard : shards) {
+        total += shard.inventory.getTotalItems();
+    }
+    return total;
+}
+
+std::vector<ItemDelta> ShardedInventory::takeChanges() {
+    std::vector<ItemDelta> taken;
+    taken.swap(pendingChanges);
+    for (auto &shard : shards) {
+        if (shard.loaded) {
+            auto changes = shard.inventory.takeChanges();
+            if (!shard.unreadable && !manifestUnreadable) {
+                std::move(changes.begin(), changes.end(), std::back_inserter(taken));
+            }
+        }
+    }
+    return taken;
+}
+
+bool ShardedInventory::save() {
+    // Without the manifest the shard layout is unknown, so any write could hide existing data
+    if (manifestUnreadable) {
+        bool changed = std::any_of(shards.begin(), shards.end(), [](const Shard &shard) { return shard.dirty; });
+        if (changed) {
+            std::cerr << "Error: Changes were not saved because the shard manifest is unreadable\n";
+        }
+        return !changed;
+    }
+
+    bool success = true;
+
+    for (std::size_t i = 0; i < shards.size(); i++) {
+        Shard &shard = shards[i];
+        if (!shard.loaded || !(shard.dirty || shard.migrating || shard.indexStale)) {
+            continue;
+        }
+        if (shard.unreadable) {
+            // Saving would replace the unreadable file with whatever this run added
+            if (shard.dirty) {
+                std::cerr << "Error: Changes to unreadable shard " << i << " were not saved\n";
+                success = false;
+            }
+            continue;
+        }
+
+        std::string filename = shardFilename(i, shardCount, format);
+        if (shard.dirty || shard.migrating) {
+            bool saved = replaceFile(filename, [&shard, this](const std::string &path) {
+                return shard.inventory.saveToFile(path, format);
+            });
+            if (!saved) {
+                success = false;
+                continue;
+            }
+
+            if (shard.migrating) {
+                // A leftover file is harmless: the file in the current format is always read first
+                std::error_code error;
+                std::string otherFilename = shardFilename(i, shardCount, otherFormat(format));
+                if (!std::filesystem::remove(otherFilename, error) && error) {
+                    std::cerr << "Warning: Could not remove " << otherFilename << ": " << error.message() << "\n";
+                }
+            }
+            shard.dirty = false;
+            shard.migrating = false;
+        }
+
+        // Stamped with the data file as written, so any later change to it makes the index stale.
+        // Without indexing, an index from an earlier run is stale now and is removed
+        std::error_code error;
+        auto source = useIndex ? MappedInventory::stamp(filename) : std::nullopt;
+        bool indexed = source && replaceFile(indexFilename(i, shardCount), [&shard, &source](const std::string &path) {
+            return MappedInventory::write(path, shard.inventory.getAllItems(), *source);
+        });
+        if (!indexed) {
+            std::filesystem::remove(indexFilename(i, shardCount), error);
+        }
+        shard.indexStale = false;
+    }
+
+    // The manifest switches readers to the new layout, so only write it once every shard is in place
+    if (manifestDirty && success) {
+        for (const auto &cleared : clearedFiles) {
+            std::error_code error;
+            if (!std::filesystem::remove(cleared, error) && error) {
+                std::cerr << "Error: Could not remove " << cleared << ": " << error.message() << "\n";
+                success = false;
+            }
+        }
+    }
+
+    if (manifestDirty && success) {
+        success = replaceFile(manifestFilename(), [this](const std::string &path) {
+            std::ofstream file(path);
+            if (!file.is_open()) {
+                std::cerr << "Error: Could not open file for writing: " << path << "\n";
+                return false;
+            }
+            file << json{{"shards", shardCount}}.dump(4);
+            return static_cast<bool>(file);
+        });
+
+        if (success) {
+            for (const auto &stale : staleFiles) {
+                std::error_code error;
+                std::filesystem::remove(stale, error);
+            }
+            staleFiles.clear();
+            clearedFiles.clear();
+            manifestDirty = false;
+        }
+    }
+
+    return success;
+}
@@ -0,0 +1,208 @@
+#include "snapshot.h"
+#include <functional>
+
+struct Snapshot::Node {
+    std::string primary;
+    std::string secondary;
+    int quantity;
+    std::size_t priority;
+    NodePtr left;
+    NodePtr right;
+};
+
+namespace {
+
+// Orders keys by primary then secondary component, like std::pair
+int compareKeys(const std::string &primaryA, const std::string &secondaryA,
+                const std::string &primaryB, const std::string &secondaryB) {
+    int c = primaryA.compare(primaryB);
+    if (c != 0) return c;
+    return secondaryA.compare(secondaryB);
+}
+
+// Priority depends only on the item, so both trees get the same shape for the same contents
+std::size_t keyPriority(const std::string &name, const std::string &location) {
+    std::size_t h = std::hash<std::string>{}(name);
+    return h ^ (std::hash<std::string>{}(location) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2));
+}
+
+}
+
+Snapshot::NodePtr Snapshot::insert(const NodePtr &root, const NodePtr &node) {
+    if (!root) {
+        return node;
+    }
+
+    int c = compareKeys(node->primary, node->secondary, root->primary, root->secondary);
+    if (c == 0) {
+        // Replace the value, keep the existing children
+        auto copy = std::make_shared<Node>(*node);
+        copy->left = root->left;
+        copy->right = root->right;
+        return copy;
+    }
+
+    auto copy = std::make_shared<Node>(*root);
+    if (c < 0) {
+        NodePtr child = insert(root->left, node);
+        if (child->priority > root->priority) {
+            // Rotate right so the heap order on priorities is kept
+            copy->left = child->right;
+            auto raised = std::make_shared<Node>(*child);
+            raised->right = copy;
+            return raised;
+        }
+        copy->left = child;
+    } else {
+        NodePtr child = insert(root->right, node);
+        if (child->priority > root->priority) {
+            // Rotate left so the heap order on priorities is kept
+            copy->right = child->left;
+            auto raised = std::make_shared<Node>(*child);
+            raised->left = copy;
+            return raised;
+        }
+        copy->right = child;
+    }
+    return copy;
+}
+
+Snapshot::NodePtr Snapshot::merge(const NodePtr &left, const NodePtr &right) {
+    if (!left) return right;
+    if (!right) return left;
+
+    if (left->priority > right->priority) {
+        auto copy = std::make_shared<Node>(*left);
+        copy->right = merge(left->right, right);
+        return copy;
+    }
+    auto copy = std::make_shared<Node>(*right);
+    copy->left = merge(left, right->left);
+    return copy;
+}
+
+Snapshot::NodePtr Snapshot::erase(const NodePtr &root, const std::string &primary, const std::string &secondary) {
+    if (!root) {
+        return root;
+    }
+
+    int c = compareKeys(primary, secondary, root->primary, root->secondary);
+    if (c == 0) {
+        return merge(root->left, root->right);
+    }
+
+    NodePtr child = erase(c < 0 ? root->left : root->right, primary, secondary);
+    if (child == (c < 0 ? root->left : root->right)) {
+        // Key not present, share the whole subtree
+        return root;
+    }
+    auto copy = std::make_shared<Node>(*root);
+    (c < 0 ? copy->left : copy->right) = child;
+    return copy;
+}
+
+const Snapshot::Node* Snapshot::lookup(const NodePtr &root, const std::string &primary, const std::string &secondary) {
+    const Node* node = root.get();
+    while (node) {
+        int c = compareKeys(primary, secondary, node->primary, node->secondary);
+        if (c == 0) return node;
+        node = (c < 0 ? node->left : node->right).get();
+    }
+    return nullptr;
+}
+
+void Snapshot::collect(const NodePtr &root, const std::string *primary, bool nameFirst, std::vector<Item> &out) {
+    if (!root) {
+        return;
+    }
+
+    // Skip subtrees that cannot contain the requested primary key
+    int c = primary ? primary->compare(root->primary) : 0;
+    if (c <= 0) {
+        collect(root->left, primary, nameFirst, out);
+    }
+    if (c == 0) {
+        if (nameFirst) {
+            out.push_back(Item(root->primary, root->quantity, root->secondary));
+        } else {
+            out.push_back(Item(root->secondary, root->quantity, root->primary));
+        }
+    }
+    if (c >= 0) {
+        collect(root->right, primary, nameFirst, out);
+    }
+}
+
+Snapshot Snapshot::fromItems(const std::vector<Item> &items) {
+    Snapshot snapshot;
+    for (const auto &item : items) {
+        int current = snapshot.getQuantity(item.getName(), item.getLocation());
+        snapshot = snapshot.withQuantity(item.getName(), item.getLocation(), current + item.getQuantity());
+    }
+    return snapshot;
+}
+
+Snapshot Snapshot::withQuantity(const std::string &name, const std::string &location, int quantity) const {
+    Snapshot next = *this;
+    bool exists = lookup(byName, name, location) != nullptr;
+
+    if (quantity == 0) {
+        if (exists) {
+            next.byName = erase(byName, name, location);
+            next.byLocation = erase(byLocation, location, name);
+            next.count--;
+        }
+        return next;
+    }
+
+    std::size_t priority = keyPriority(name, location);
+    next.byName = insert(byName, std::make_shared<Node>(Node{name, location, quantity, priority, nullptr, nullptr}));
+    next.byLocation = insert(byLocation, std::make_shared<Node>(Node{location, name, quantity, priority, nullptr, nullptr}));
+    if (!exists) {
+        next.count++;
+    }
+    return next;
+}
+
+int Snapshot::getQuantity(const std::string &name, const std::string &location) const {
+    const Node* node = lookup(byName, name, location);
+    return node ? node->quantity : 0;
+}
+
+std::vector<Item> Snapshot::getAllItems() const {
+    std::vector<Item> result;
+    result.reserve(count);
+    collect(byName, nullptr, true, result);
+    return result;
+}
+
+std::optional<Item> Snapshot::findItem(const std::string &name) const {
+    // Leftmost node with a matching name holds the first location
+    const Node* found = nullptr;
+    const Node* node = byName.get();
+    while (node) {
+        int c = name.compare(node->primary);
+        if (c <= 0) {
+            if (c == 0) found = node;
+            node = node->left.get();
+        } else {
+            node = node->right.get();
+        }
+    }
+
+    if (found) {
+        return Item(found->primary, found->quantity, found->secondary);
+    }
+    return std::nullopt;
+}
+
+std::vector<Item> Snapshot::getItemsByLocation(const std::string &location) const {
+    std::vector<Item> result;
+    collect(byLocation, &location, false, result);
+    return result;
+}
+
+int Snapshot::getTotalItems() const {
+    return count;
+}
+